@@ -0,0 +1,368 @@
+/* Zeitquelle für die Zyklus-Logik
+=====================================================================================================
+Autor: Alexander Weber
+Datum: Juli 2025
+
+Gemeinsame Schnittstelle von secure_rt_thread.c und secure_rt_server.c für
+clock_gettime()/clock_nanosleep() auf CLOCK_MONOTONIC. Zwei Implementierungen:
+
+  rt_system_clock         - echte Zeit (Normalbetrieb)
+  rt_virtual_clock_init() - simulierte Zeit für schnelle, deterministische Läufe
+
+Die virtuelle Uhr ist ein Discrete-Event-Simulator: Schlafen kostet keine
+Echtzeit, die Uhr springt zum nächsten Ereignis, sobald ALLE angemeldeten
+Threads (rt_clock_attach) in der Uhr blockiert sind - schlafend oder rechnend.
+Ergebnisse hängen damit nicht von der realen Thread-Verschränkung ab.
+Verzögerungen werden injiziert über
+  - Weck-Jitter: 0..max_jitter_ns pro Schlaf, aus einem LCG-Zustand des Aufrufers
+  - rt_clock_consume(): simulierte Ausführungszeit (echte Uhr: keine Wirkung)
+
+CPU-Modell: Die virtuelle Uhr hat eine feste Zahl CPUs. Rechenzeit aus
+rt_clock_consume() läuft nur auf einer CPU; vergeben wird wie bei SCHED_FIFO
+(höhere Priorität verdrängt, gleiche Priorität in Ankunftsreihenfolge, bei
+gleicher Ankunft entscheidet der Schlüssel 'order' des Aufrufers). Wer keine
+CPU bekommt, wartet - Überlast zeigt sich als Verspätung.
+=====================================================================================================*/
+
+#ifndef RT_CLOCK_H
+#define RT_CLOCK_H
+
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+
+typedef struct rt_clock rt_clock_t;
+
+// In der virtuellen Uhr blockierter Thread (liegt auf dessen Stack):
+// schlafend (waiters) oder auf/um eine CPU rechnend (jobs)
+typedef struct rt_clock_waiter {
+    long long target_ns;         // Schlaf: Weckzeitpunkt
+    long long remaining_ns;      // Rechnen: verbleibende Ausführungszeit
+    long long ready_ns;          // Rechnen: Ankunft (FIFO innerhalb der Priorität)
+    int priority;
+    int order;
+    int done;
+    pthread_cond_t wake;
+    struct rt_clock_waiter* next;
+} rt_clock_waiter_t;
+
+struct rt_clock {
+    const char* name;
+    int simulated;
+    int (*now)(rt_clock_t* clock, struct timespec* t);
+    // Wie clock_nanosleep(TIMER_ABSTIME): 0 oder Fehlercode (EINTR möglich)
+    int (*sleep_until)(rt_clock_t* clock, const struct timespec* target, uint32_t* jitter_state,
+                       int priority, int order);
+    void (*consume)(rt_clock_t* clock, long long ns, int priority, int order);
+    void (*attach)(rt_clock_t* clock);
+    void (*detach)(rt_clock_t* clock);
+    
+    // Zustand der virtuellen Uhr (von rt_system_clock nicht verwendet)
+    pthread_mutex_t lock;
+    long long now_ns;
+    long long max_jitter_ns;
+    int cpus;                    // Virtuelle CPUs für rt_clock_consume()
+    rt_clock_waiter_t* waiters;  // Schlafende Threads
+    rt_clock_waiter_t* jobs;     // Rechnende Threads, sortiert: die ersten 'cpus' laufen
+    int participants;            // Angemeldete Threads
+    int blocked;                 // Davon gerade schlafend oder rechnend
+    unsigned long advances;      // Zählt die Sprünge
+    long long busy_ns;           // Summe der vergebenen CPU-Zeit (Auslastung)
+};
+
+static inline long long rt_clock_ts_ns(const struct timespec* t) {
+    return (long long)t->tv_sec * 1000000000LL + t->tv_nsec;
+}
+
+static inline void rt_clock_ns_ts(long long ns, struct timespec* t) {
+    t->tv_sec = ns / 1000000000LL;
+    t->tv_nsec = ns % 1000000000LL;
+}
+
+// Deterministischer Weck-Jitter (LCG nach Numerical Recipes)
+static inline long long rt_clock_jitter(const rt_clock_t* clock, uint32_t* state) {
+    if (state == NULL || clock->max_jitter_ns <= 0) {
+        return 0;
+    }
+    *state = *state * 1664525u + 1013904223u;
+    return (long long)(*state >> 8) % (clock->max_jitter_ns + 1);
+}
+
+// ========================================
+// ECHTE UHR
+// ========================================
+static int rt_system_now(rt_clock_t* clock, struct timespec* t) {
+    (void)clock;
+    return clock_gettime(CLOCK_MONOTONIC, t);
+}
+
+static int rt_system_sleep_until(rt_clock_t* clock, const struct timespec* target, uint32_t* jitter_state,
+                                 int priority, int order) {
+    (void)clock;
+    (void)jitter_state;   // Echter Jitter kommt vom System
+    (void)priority;
+    (void)order;
+    return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, target, NULL);
+}
+
+static void rt_system_consume(rt_clock_t* clock, long long ns, int priority, int order) {
+    (void)clock;
+    (void)ns;             // Echte Arbeit verbraucht echte Zeit, der Kernel vergibt die CPU
+    (void)priority;
+    (void)order;
+}
+
+static void rt_system_attach(rt_clock_t* clock) {
+    (void)clock;
+}
+
+static rt_clock_t rt_system_clock = {
+    .name = "system",
+    .simulated = 0,
+    .now = rt_system_now,
+    .sleep_until = rt_system_sleep_until,
+    .consume = rt_system_consume,
+    .attach = rt_system_attach,
+    .detach = rt_system_attach,
+};
+
+// ========================================
+// VIRTUELLE UHR
+// ========================================
+// Reihenfolge der CPU-Vergabe: Priorität absteigend, dann Ankunft, dann order
+static int rt_virtual_job_before(const rt_clock_waiter_t* a, const rt_clock_waiter_t* b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    if (a->ready_ns != b->ready_ns) {
+        return a->ready_ns < b->ready_ns;
+    }
+    return a->order < b->order;
+}
+
+// Aufrufer hält lock: reiht einen Job nach rt_virtual_job_before() ein
+static void rt_virtual_enqueue(rt_clock_t* clock, rt_clock_waiter_t* job) {
+    rt_clock_waiter_t** link = &clock->jobs;
+    while (*link != NULL && !rt_virtual_job_before(job, *link)) {
+        link = &(*link)->next;
+    }
+    job->next = *link;
+    *link = job;
+}
+
+// Aufrufer hält lock. Sind alle angemeldeten Threads blockiert, springt die
+// Uhr zum nächsten Ereignis (Weckzeitpunkt oder Ende eines laufenden Jobs)
+// und rechnet den laufenden Jobs die Zeit an. Fällige Schläfer werden zu
+// Jobs ohne Rechenzeit: Sie laufen erst weiter, wenn sie eine CPU bekommen
+// (Verdrängung niedrigerer Prioritäten, Warten hinter höheren).
+static void rt_virtual_try_advance(rt_clock_t* clock) {
+    // Ein Sprung kann niemanden wecken (fällige Schläfer warten auf eine CPU):
+    // dann sofort zum nächsten Ereignis weiter
+    while (clock->blocked == clock->participants) {
+        if (clock->participants <= 0 || (clock->waiters == NULL && clock->jobs == NULL)) {
+            return;
+        }
+        
+        long long next_ns = LLONG_MAX;
+        for (rt_clock_waiter_t* w = clock->waiters; w != NULL; w = w->next) {
+            if (w->target_ns < next_ns) {
+                next_ns = w->target_ns;
+            }
+        }
+        int cpu = 0;
+        for (rt_clock_waiter_t* j = clock->jobs; j != NULL && cpu < clock->cpus; j = j->next, cpu++) {
+            if (clock->now_ns + j->remaining_ns < next_ns) {
+                next_ns = clock->now_ns + j->remaining_ns;
+            }
+        }
+        
+        long long elapsed = next_ns - clock->now_ns;
+        clock->now_ns = next_ns;
+        clock->advances++;
+        
+        // Laufende Jobs (die ersten 'cpus' der sortierten Liste) rechnen,
+        // fertige geben ihre CPU frei
+        rt_clock_waiter_t** link = &clock->jobs;
+        cpu = 0;
+        while (*link != NULL && cpu < clock->cpus) {
+            rt_clock_waiter_t* j = *link;
+            j->remaining_ns -= elapsed;
+            clock->busy_ns += elapsed;
+            cpu++;
+            if (j->remaining_ns <= 0) {
+                *link = j->next;
+                clock->blocked--;
+                j->done = 1;
+                pthread_cond_signal(&j->wake);
+            } else {
+                link = &j->next;
+            }
+        }
+        
+        link = &clock->waiters;
+        while (*link != NULL) {
+            rt_clock_waiter_t* w = *link;
+            if (w->target_ns <= clock->now_ns) {
+                *link = w->next;
+                w->remaining_ns = 0;
+                w->ready_ns = clock->now_ns;
+                rt_virtual_enqueue(clock, w);
+            } else {
+                link = &w->next;
+            }
+        }
+        
+        // Jobs ohne Rechenzeit auf einer CPU laufen weiter. Bis sie wieder in der
+        // Uhr blockieren, vergeht keine virtuelle Zeit; die CPU bleibt solange belegt.
+        link = &clock->jobs;
+        cpu = 0;
+        while (*link != NULL && cpu < clock->cpus) {
+            rt_clock_waiter_t* j = *link;
+            cpu++;
+            if (j->remaining_ns <= 0) {
+                *link = j->next;
+                clock->blocked--;
+                j->done = 1;
+                pthread_cond_signal(&j->wake);
+            } else {
+                link = &j->next;
+            }
+        }
+    }
+}
+
+static int rt_virtual_now(rt_clock_t* clock, struct timespec* t) {
+    pthread_mutex_lock(&clock->lock);
+    rt_clock_ns_ts(clock->now_ns, t);
+    pthread_mutex_unlock(&clock->lock);
+    return 0;
+}
+
+// Aufrufer hält lock: blockiert bis try_advance() den Eintrag erledigt hat
+static void rt_virtual_block(rt_clock_t* clock, rt_clock_waiter_t* self) {
+    clock->blocked++;
+    rt_virtual_try_advance(clock);   // Evtl. war dieser Thread der letzte wache
+    while (!self->done) {
+        pthread_cond_wait(&self->wake, &clock->lock);
+    }
+}
+
+// Nach dem Wecken wartet der Thread mit priority/order auf eine CPU
+static int rt_virtual_sleep_until(rt_clock_t* clock, const struct timespec* target, uint32_t* jitter_state,
+                                  int priority, int order) {
+    pthread_mutex_lock(&clock->lock);
+    long long target_ns = rt_clock_ts_ns(target);
+    
+    // Bereits fällig (Überlauf): sofort zurück, wie clock_nanosleep()
+    if (target_ns <= clock->now_ns) {
+        pthread_mutex_unlock(&clock->lock);
+        return 0;
+    }
+    rt_clock_waiter_t self = { 0 };
+    self.target_ns = target_ns + rt_clock_jitter(clock, jitter_state);
+    self.priority = priority;
+    self.order = order;
+    pthread_cond_init(&self.wake, NULL);
+    self.next = clock->waiters;
+    clock->waiters = &self;
+    
+    rt_virtual_block(clock, &self);
+    pthread_mutex_unlock(&clock->lock);
+    pthread_cond_destroy(&self.wake);
+    return 0;
+}
+
+// Reiht ns Rechenzeit nach Priorität ein und kehrt zurück, wenn sie auf einer
+// virtuellen CPU abgearbeitet ist (inklusive Wartezeit auf eine freie CPU)
+static void rt_virtual_consume(rt_clock_t* clock, long long ns, int priority, int order) {
+    if (ns <= 0) {
+        return;
+    }
+    pthread_mutex_lock(&clock->lock);
+    rt_clock_waiter_t self = { 0 };
+    self.remaining_ns = ns;
+    self.ready_ns = clock->now_ns;
+    self.priority = priority;
+    self.order = order;
+    pthread_cond_init(&self.wake, NULL);
+    rt_virtual_enqueue(clock, &self);
+    
+    rt_virtual_block(clock, &self);
+    pthread_mutex_unlock(&clock->lock);
+    pthread_cond_destroy(&self.wake);
+}
+
+static void rt_virtual_attach(rt_clock_t* clock) {
+    pthread_mutex_lock(&clock->lock);
+    clock->participants++;
+    pthread_mutex_unlock(&clock->lock);
+}
+
+static void rt_virtual_detach(rt_clock_t* clock) {
+    pthread_mutex_lock(&clock->lock);
+    clock->participants--;
+    rt_virtual_try_advance(clock);   // Der Rest wartet evtl. nur noch auf diesen Thread
+    pthread_mutex_unlock(&clock->lock);
+}
+
+// Initialisiert eine virtuelle Uhr ab start_ns mit 'cpus' virtuellen CPUs.
+// Teilnehmer werden vor dem Start der Threads angemeldet, damit kein Thread
+// allein vorausläuft.
+static inline void rt_virtual_clock_init(rt_clock_t* clock, long long start_ns, long long max_jitter_ns, int cpus) {
+    clock->name = "virtual";
+    clock->simulated = 1;
+    clock->now = rt_virtual_now;
+    clock->sleep_until = rt_virtual_sleep_until;
+    clock->consume = rt_virtual_consume;
+    clock->attach = rt_virtual_attach;
+    clock->detach = rt_virtual_detach;
+    pthread_mutex_init(&clock->lock, NULL);
+    clock->now_ns = start_ns;
+    clock->max_jitter_ns = max_jitter_ns;
+    clock->cpus = cpus > 0 ? cpus : 1;
+    clock->waiters = NULL;
+    clock->jobs = NULL;
+    clock->participants = 0;
+    clock->blocked = 0;
+    clock->advances = 0;
+    clock->busy_ns = 0;
+}
+
+// Bequeme Aufrufe, analog zu clock_gettime()/clock_nanosleep()
+static inline int rt_clock_now(rt_clock_t* clock, struct timespec* t) {
+    return clock->now(clock, t);
+}
+
+// priority wie SCHED_FIFO (höher = wichtiger), order = eindeutiger Schlüssel
+// des Aufrufers für gleichzeitige Ankünfte gleicher Priorität
+static inline int rt_clock_sleep_until(rt_clock_t* clock, const struct timespec* target, uint32_t* jitter_state,
+                                       int priority, int order) {
+    return clock->sleep_until(clock, target, jitter_state, priority, order);
+}
+
+static inline void rt_clock_consume(rt_clock_t* clock, long long ns, int priority, int order) {
+    clock->consume(clock, ns, priority, order);
+}
+
+static inline void rt_clock_attach(rt_clock_t* clock) {
+    clock->attach(clock);
+}
+
+static inline void rt_clock_detach(rt_clock_t* clock) {
+    clock->detach(clock);
+}
+
+// FNV-1a über einen Messwert: Prüfsumme, mit der sich zwei Läufe vergleichen lassen
+static inline uint64_t rt_clock_digest(uint64_t digest, long long value) {
+    for (int i = 0; i < 8; i++) {
+        digest ^= (uint64_t)(value >> (i * 8)) & 0xff;
+        digest *= 1099511628211ULL;
+    }
+    return digest;
+}
+
+#define RT_CLOCK_DIGEST_INIT 14695981039346656037ULL
+
+#endif // RT_CLOCK_H
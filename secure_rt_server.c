@@ -25,28 +25,280 @@ IP-Adressen akzeptiert und nach erfolgreicher Authentifizierung Echtzeit-Threads
 #include <arpa/inet.h>
 #include <sys/mman.h>
 #include <signal.h>
+#include <getopt.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <semaphore.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <linux/filter.h>     // Für klassisches BPF (Reuseport-Steering)
+#include <linux/net_tstamp.h> // Für SO_TIMESTAMPING (TX-Zeitstempel)
+#include <linux/errqueue.h>   // Für struct scm_timestamping
+#include <openssl/ssl.h>       // TLS-Handshake, danach kTLS-Offload
+#include <openssl/err.h>
+#include "rt_clock.h"      // Zeitquelle: echte oder virtuelle Uhr (Simulation)
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
 
 // Server-Konstanten
 #define SERVER_PORT 8080
-#define MAX_CLIENTS 5
 #define BUFFER_SIZE 256
 
+// Listener-Konstanten (Defaults, per Kommandozeile überschreibbar)
+#define DEFAULT_LISTEN_BACKLOG 1024   // Wird vom Kernel auf net.core.somaxconn begrenzt
+#define DEFAULT_ACCEPTORS 1           // Anzahl Acceptor-Threads mit eigenem SO_REUSEPORT-Socket
+#define MAX_ACCEPTORS 64
+#define DEFAULT_RATE_LIMIT 10         // Neue Verbindungen pro Sekunde und IP
+#define DEFAULT_RATE_BURST 20         // Maximale Burst-Größe pro IP
+#define ACCEPT_POLL_MS 100            // Poll-Intervall der Acceptoren (Flags prüfen)
+#define DEFAULT_MAX_HANDSHAKES 64         // Gleichzeitige Anmeldungen (älteste nicht angemeldete wird verdrängt)
+#define DEFAULT_USERNAME_TIMEOUT_MS 5000  // Frist Verbindung -> Anmeldezeile
+#define DEFAULT_START_TIMEOUT_MS 2000     // Frist Anmeldung -> RT-Start (Uhrenabgleich)
+#define DEFAULT_TLS_KEY "server.key"      // Schlüssel zum Zertifikat (-C), siehe "make certs"
+#define MAX_SESSIONS 1024             // Maximale gleichzeitige Client-Sitzungen
+
+// Latenzmessung
+#define CLOCK_SYNC_WINDOW_MS 200      // Wartezeit auf SYNC-Pings des Clients nach der Anmeldung
+#define MAX_CLOCK_SYNC_SAMPLES 32     // Maximale Anzahl beantworteter SYNC-Pings
+
+// Veröffentlichter RT-Zustand
+#define SEQLOCK_READ_RETRIES 1000     // Leser geben nach so vielen Kollisionen auf
+
+// Handover-Konstanten (unterbrechungsfreier Neustart)
+#define DEFAULT_HANDOVER_PATH "/tmp/secure_rt_server.sock"
+#define HANDOVER_MAGIC 0x53525448     // "SRTH"
+#define HANDOVER_VERSION 3
+#define HANDOVER_TIMEOUT_MS 2000      // Maximale Wartezeit auf das Parken der Sitzungen
+
 // Echtzeit-Konstanten
 #define RT_PRIORITY 50
 #define TASK_PERIOD_SEC 1
-#define MAX_CYCLES 20
+#define MAX_CYCLES 20                 // Default der Zyklen pro Sitzung (-n)
 
 // Sicherheitskonstanten
 #define MAX_USERNAME_LENGTH 50
-#define AUTHORIZED_USER "admin"
+#define AUTHORIZED_USER "admin"       // Standardbenutzer, falls keine Benutzerdatenbank existiert
+
+// Benutzerdatenbank und Admission Control
+#define DEFAULT_USER_DB "users.conf"
+#define USER_TABLE_SIZE 256           // Hash-Tabelle (Zweierpotenz, offene Adressierung)
+#define DEFAULT_MAX_SESSIONS 4        // Limits des Standardbenutzers
+#define DEFAULT_MIN_PERIOD_MS 100
+#define DEFAULT_CPU_BUDGET_PERCENT 10.0
+#define DEFAULT_CYCLE_COST_US 200     // Kostenschätzung pro Zyklus, solange nichts gemessen ist
+#define RT_UTILIZATION_LIMIT 0.7      // Maximale RT-Auslastung pro CPU (Rest für Nicht-RT)
+#define CPU_COST_EWMA_SHIFT 3         // Glättung der gemessenen Zykluskosten (1/8)
+
+// Simulation (virtuelle Uhr, -V)
+#define MAX_SIM_SESSIONS 256         // Je Sitzung zwei Threads und zwei Sockets
 
 // Netzwerksicherheitskonstanten
 #define AUTHORIZED_IP "127.0.0.1"     // Autorisierte Client-IP
 #define ALTERNATIVE_IP "192.168.1.100" // Alternative autorisierte Client-IP
 
+// ========================================
+// SERVER-KONFIGURATION
+// ========================================
+// Laufzeitparameter des Listeners, in main() aus der Kommandozeile gelesen
+typedef struct {
+    int listen_backlog;      // Backlog pro Listener-Socket
+    int acceptor_count;      // Anzahl SO_REUSEPORT-Listener/Acceptor-Threads
+    int cpu_steering;        // 1 = Verbindungen per BPF auf Acceptor der Empfangs-CPU lenken
+    double rate_limit;       // Verbindungen pro Sekunde und IP (0 = unbegrenzt)
+    double rate_burst;       // Token-Bucket-Größe pro IP
+    const char* handover_path; // Unix-Socket für den Handover an einen Nachfolger
+    int takeover;            // 1 = Listener und Sitzungen vom Vorgänger übernehmen
+    int tx_timestamps;       // 1 = SO_TIMESTAMPING: Kernel-TX-Zeitstempel pro Zyklus messen
+    int metrics_interval;    // Sekunden zwischen Metrik-Ausgaben (0 = aus)
+    const char* user_db_path; // Benutzerdatenbank mit Quoten
+    int rt_cpus;             // CPUs für RT-Sitzungen (Admission-Kapazität)
+    int max_handshakes;      // Obergrenze nicht gestarteter Anmeldungen
+    int username_timeout_ms; // Frist bis zur Anmeldezeile
+    int start_timeout_ms;    // Frist von der Anmeldung bis zum RT-Start
+    const char* tls_cert;    // Zertifikat (PEM); gesetzt = TLS 1.3 für alle Clients
+    const char* tls_key;     // Privater Schlüssel (PEM)
+    int cycles;              // Zyklen pro Sitzung
+    int sim_sessions;        // > 0 = Simulation mit N Sitzungen auf virtueller Uhr, ohne Netzwerk
+    long long sim_jitter_us; // Maximaler Weck-Jitter der virtuellen Uhr
+    long long sim_cost_us;   // Simulierte Ausführungszeit pro Zyklus
+    int sim_period_ms;       // Periode der simulierten Sitzungen
+} server_config_t;
+
+server_config_t server_config = {
+    .listen_backlog = DEFAULT_LISTEN_BACKLOG,
+    .acceptor_count = DEFAULT_ACCEPTORS,
+    .cpu_steering = 0,
+    .rate_limit = DEFAULT_RATE_LIMIT,
+    .rate_burst = DEFAULT_RATE_BURST,
+    .handover_path = DEFAULT_HANDOVER_PATH,
+    .takeover = 0,
+    .tx_timestamps = 0,
+    .metrics_interval = 0,
+    .user_db_path = DEFAULT_USER_DB,
+    .rt_cpus = 0,            // 0 = alle Online-CPUs
+    .max_handshakes = DEFAULT_MAX_HANDSHAKES,
+    .username_timeout_ms = DEFAULT_USERNAME_TIMEOUT_MS,
+    .start_timeout_ms = DEFAULT_START_TIMEOUT_MS,
+    .tls_cert = NULL,
+    .tls_key = DEFAULT_TLS_KEY,
+    .cycles = MAX_CYCLES,
+    .sim_sessions = 0,
+    .sim_jitter_us = 0,
+    .sim_cost_us = DEFAULT_CYCLE_COST_US,
+    .sim_period_ms = TASK_PERIOD_SEC * 1000,
+};
+
+SSL_CTX* tls_ctx = NULL;     // Nur gesetzt, wenn TLS aktiv ist
+
+// Zeitquelle der RT-Zyklen; im Simulationsmodus die virtuelle Uhr
+rt_clock_t* rt_clock = &rt_system_clock;
+rt_clock_t virtual_clock;
+
+// ========================================
+// BENUTZERDATENBANK
+// ========================================
+// Wird beim Start aus user_db_path geladen und danach nur noch gelesen.
+// Jeder Benutzer hat eigene RT-Quoten; die Suche erfolgt per FNV-1a-Hash
+// mit linearer Sondierung.
+typedef struct {
+    char name[MAX_USERNAME_LENGTH];
+    int in_use;
+    int max_sessions;        // Gleichzeitige Sitzungen
+    int max_priority;        // Höchste SCHED_FIFO-Priorität
+    long long min_period_ns; // Kürzeste erlaubte Zyklusperiode
+    double cpu_budget;       // CPU-Anteil aller Sitzungen des Benutzers (1.0 = eine CPU)
+} user_entry_t;
+
+user_entry_t user_table[USER_TABLE_SIZE];
+int user_count = 0;
+
+// ========================================
+// ACCEPTOR-DATENSTRUKTUR
+// ========================================
+// Jeder Acceptor besitzt einen eigenen Listener-Socket in derselben
+// SO_REUSEPORT-Gruppe; der Kernel verteilt eingehende Verbindungen auf alle
+// Listener, sodass kein einzelner accept()-Thread zum Flaschenhals wird.
+typedef struct {
+    int index;
+    int listen_socket;
+    pthread_t thread_id;
+    unsigned long accepted;        // An den Handshake-Reaktor übergeben
+    unsigned long rejected_ip;     // Von der Allowlist abgewiesen
+    unsigned long rejected_rate;   // Vom Rate-Limit abgewiesen
+    unsigned long rejected_queue;  // Übergabe-Pipe zum Reaktor voll
+    volatile int idle;             // 1 = nimmt wegen Handover nichts mehr an
+} acceptor_t;
+
+// ========================================
+// ALLOWLIST MIT RATE-LIMIT
+// ========================================
+// Die autorisierten IPs werden einmalig in Binärform umgewandelt, damit die
+// Prüfung direkt nach accept() nur ein Integer-Vergleich ist. Jeder Eintrag
+// trägt seinen eigenen Token-Bucket für das Verbindungs-Rate-Limit.
+typedef struct {
+    const char* ip;
+    const char* label;
+    in_addr_t addr;
+    double tokens;
+    struct timespec last_refill;
+} allowed_peer_t;
+
+allowed_peer_t allowed_peers[] = {
+    { AUTHORIZED_IP,  "Primary",     0, 0.0, { 0, 0 } },
+    { ALTERNATIVE_IP, "Alternative", 0, 0.0, { 0, 0 } },
+};
+#define ALLOWED_PEER_COUNT ((int)(sizeof(allowed_peers) / sizeof(allowed_peers[0])))
+pthread_mutex_t rate_limit_mutex;   // PTHREAD_PRIO_INHERIT, siehe init_pi_mutex()
+
 // Globale Variablen für sauberes Shutdown
 volatile int server_running = 1;
-int server_socket = -1;
+acceptor_t acceptors[MAX_ACCEPTORS];
+int acceptor_count = 0;
+
+// Handover-Status: handover_requested friert RT-Sitzungen an der nächsten
+// Zyklusgrenze ein, handover_done verhindert das Löschen des Unix-Sockets,
+// den der Nachfolger bereits neu gebunden hat
+volatile sig_atomic_t handover_requested = 0;
+volatile int handover_done = 0;
+int handover_socket = -1;
+
+// ========================================
+// VERÖFFENTLICHTER RT-ZUSTAND (SEQLOCK)
+// ========================================
+// Jeder RT-Thread veröffentlicht seinen Zustand nach jedem Zyklus in einem
+// Seqlock. Der (einzige) Schreiber blockiert und wiederholt nie: Er macht die
+// Sequenz ungerade, kopiert die Daten und macht sie wieder gerade. Leser
+// (Metrik-Thread, STATS-Kommando) kopieren ohne Lock und wiederholen, falls
+// sich die Sequenz währenddessen geändert hat oder ungerade war.
+typedef struct {
+    int active;                  // 1 solange der RT-Thread läuft
+    int cycle_count;
+    long long last_cycle_ns;     // CLOCK_MONOTONIC des letzten Zyklus
+    long long next_deadline_ns;  // Nächster Zyklus laut Raster
+    long long last_lateness_ns;  // Verspätung des letzten Zyklus gegenüber dem Raster
+    long long max_lateness_ns;
+    unsigned long send_errors;
+    long long cycle_cpu_avg_ns;  // Gemessene CPU-Zeit pro Zyklus (EWMA)
+    long long cycle_cpu_max_ns;
+} rt_state_t;
+
+typedef struct {
+    atomic_uint sequence;
+    rt_state_t data;
+} rt_state_seqlock_t;
+
+// Nur vom RT-Thread der Sitzung aufgerufen (ein Schreiber pro Seqlock)
+void rt_state_publish(rt_state_seqlock_t* lock, const rt_state_t* state) {
+    unsigned int seq = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    
+    atomic_store_explicit(&lock->sequence, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&lock->data, state, sizeof(*state));
+    atomic_store_explicit(&lock->sequence, seq + 2, memory_order_release);
+}
+
+// Liefert 1 und einen konsistenten Snapshot, oder 0 nach SEQLOCK_READ_RETRIES Kollisionen
+int rt_state_read(rt_state_seqlock_t* lock, rt_state_t* snapshot) {
+    for (int attempt = 0; attempt < SEQLOCK_READ_RETRIES; attempt++) {
+        unsigned int before = atomic_load_explicit(&lock->sequence, memory_order_acquire);
+        if (before & 1) {
+            continue;   // Schreiber mitten im Update
+        }
+        memcpy(snapshot, &lock->data, sizeof(*snapshot));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&lock->sequence, memory_order_relaxed) == before) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ========================================
+// PRIORITY-INHERITANCE-MUTEX
+// ========================================
+// Wo ein Lock unvermeidbar ist (Register, Rate-Limit), erbt der Halter die
+// Priorität eines blockierten SCHED_FIFO-Threads - keine Prioritätsinversion
+int init_pi_mutex(pthread_mutex_t* mutex) {
+    pthread_mutexattr_t attr;
+    int ret;
+    
+    pthread_mutexattr_init(&attr);
+    ret = pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    if (ret == 0) {
+        ret = pthread_mutex_init(mutex, &attr);
+    }
+    pthread_mutexattr_destroy(&attr);
+    
+    if (ret != 0) {
+        printf("Warnung: PTHREAD_PRIO_INHERIT nicht verfügbar: %s\n", strerror(ret));
+        ret = pthread_mutex_init(mutex, NULL);
+    }
+    return ret == 0;
+}
 
 // ========================================
 // CLIENT-DATENSTRUKTUR
@@ -57,14 +309,87 @@ int server_socket = -1;
 // und deren Verbindungen zu verwalten
 // Enthält Socket, Adresse, IP und Authentifizierungsstatus
 // Wird in handle_client() verwendet, um Threads für jeden Client zu starten
+//
+// Der Zyklus-Zustand (cycle_count, next_period) liegt ebenfalls hier, damit
+// eine Sitzung beim Handover eingefroren und im Nachfolger fortgesetzt werden kann
+typedef enum {
+    SESSION_HANDSHAKE,   // IP geprüft, Authentifizierung läuft
+    SESSION_STARTING,    // Angemeldet oder übernommen, Handler startet den RT-Thread
+    SESSION_RUNNING,     // RT-Thread läuft
+    SESSION_PARKED,      // Für Handover eingefroren, gehört dem Handover-Thread
+    SESSION_CLOSING,     // RT-Thread beendet (nicht mehr signalisierbar), Handler räumt auf
+    SESSION_STATE_COUNT  // Anzahl der Zustände (Größe von session_state_names)
+} session_state_t;
+
 typedef struct {
     int client_socket;
     struct sockaddr_in client_addr;
     char client_ip[INET_ADDRSTRLEN];
     int authenticated;
-    pthread_t thread_id;
+    pthread_t thread_id;            // RT-Thread der Sitzung (gültig in SESSION_RUNNING)
+    sem_t rt_exited;                // Vom RT-Thread am Ende gepostet, vor dem join()
+    session_state_t state;
+    int started;                    // Startmeldung bereits gesendet
+    int cycle_count;                // Bereits ausgeführte Zyklen
+    long long period_ns;            // Periode des Zyklus-Rasters
+    int priority;                   // SCHED_FIFO-Priorität des RT-Threads
+    const user_entry_t* user;       // Angemeldeter Benutzer (Quoten)
+    int admitted;                   // Von der Admission Control zugelassen
+    double reserved_util;           // Reservierte CPU-Auslastung (Schätzung bei Zulassung)
+    SSL* ssl;                       // TLS-Verbindung (NULL = Klartext oder übernommen)
+    int ktls_tx;                    // Senden verschlüsselt der Kernel (plain send())
+    int ktls_rx;                    // Empfangen entschlüsselt der Kernel
+    struct timespec next_period;    // Absoluter Zeitpunkt des nächsten Zyklus
+    volatile int parked;            // RT-Thread hat für Handover angehalten
+    int resumed;                    // Vom Vorgänger übernommen
+    struct timespec freeze_time;    // Zeitpunkt des Einfrierens (nur bei resumed)
+    struct timespec last_send_realtime; // CLOCK_REALTIME direkt vor dem letzten send()
+    unsigned long tx_stamp_count;   // Empfangene Kernel-TX-Zeitstempel
+    long long tx_delay_sum_ns;      // Summe send() -> Kernel-TX
+    long long tx_delay_max_ns;
+    rt_state_t rt_state;            // Arbeitskopie des RT-Threads
+    rt_state_seqlock_t published;   // Für Nicht-RT-Leser veröffentlicht
+    uint32_t jitter_state;          // LCG-Zustand für den Weck-Jitter der virtuellen Uhr
+    int sim_index;                  // Reihenfolge bei gleichzeitiger CPU-Anfrage (nur Simulation)
+    uint64_t lateness_digest;       // Prüfsumme der Lateness-Folge (nur Simulation)
+    long long lateness_sum_ns;
+    unsigned long overrun_count;    // Zyklen mit Lateness > Periode (nur Simulation)
 } client_info_t;
 
+// ========================================
+// SITZUNGSREGISTER
+// ========================================
+// Alle Sitzungen des Prozesses, damit der Handover sie einfrieren und
+// übergeben kann. Nur Handler-, Handover- und Metrik-Thread nehmen den Mutex
+// (sichert die Lebensdauer der client_info_t), die RT-Threads selbst nie.
+client_info_t* sessions[MAX_SESSIONS];
+int session_count = 0;
+pthread_mutex_t session_mutex;   // PTHREAD_PRIO_INHERIT, siehe init_pi_mutex()
+
+int register_session(client_info_t* client) {
+    int ok = 0;
+    pthread_mutex_lock(&session_mutex);
+    if (session_count < MAX_SESSIONS) {
+        sessions[session_count++] = client;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&session_mutex);
+    return ok;
+}
+
+// Aufrufer hält session_mutex
+void unregister_session_locked(client_info_t* client) {
+    for (int i = 0; i < session_count; i++) {
+        if (sessions[i] == client) {
+            sessions[i] = sessions[--session_count];
+            break;
+        }
+    }
+}
+
+void* handle_client(void* arg);
+void free_client_info(client_info_t* client);
+
 // ========================================
 // SIGNAL-HANDLER FÜR SAUBERES SHUTDOWN
 // ========================================
@@ -75,348 +400,2602 @@ void signal_handler(int sig) {
     printf("Signal %d empfangen, beende Server...\n", sig);
     server_running = 0;
     
-    if (server_socket != -1) {
-        close(server_socket);
+    // shutdown() weckt alle blockierten accept()-Aufrufe (async-signal-safe);
+    // geschlossen werden die Sockets erst nach dem Join der Acceptoren.
+    // Nach einem Handover gehören die Listener dem Nachfolger.
+    if (!handover_done) {
+        for (int i = 0; i < acceptor_count; i++) {
+            if (acceptors[i].listen_socket != -1) {
+                shutdown(acceptors[i].listen_socket, SHUT_RDWR);
+            }
+        }
+    }
+    if (handover_socket != -1) {
+        shutdown(handover_socket, SHUT_RDWR);
     }
 }
 
+// Weckt RT-Threads aus clock_nanosleep(), damit sie für den Handover parken
+void handover_wakeup_handler(int sig) {
+    (void)sig;
+}
+
 // ========================================
-// IP-ADRESS-AUTORISIERUNG
+// SCHNELLE ALLOWLIST-PRÜFUNG
 // ========================================
-// Überprüft ob die Client-IP autorisiert ist
-int check_client_ip_authorization(const char* client_ip) {
-    printf("Überprüfe Client-IP: %s\n", client_ip);
-    
-    // Autorisierte IPs prüfen
-    if (strcmp(client_ip, AUTHORIZED_IP) == 0) {
-        printf("✓ IP-Adresse %s ist autorisiert (Primary)\n", client_ip);
-        return 1;
-    } else if (strcmp(client_ip, ALTERNATIVE_IP) == 0) {
-        printf("✓ IP-Adresse %s ist autorisiert (Alternative)\n", client_ip);
-        return 1;
-    } else {
-        printf("✗ IP-Adresse %s ist NICHT autorisiert!\n", client_ip);
-        printf("✗ Autorisierte IPs: %s, %s\n", AUTHORIZED_IP, ALTERNATIVE_IP);
-        return 0;
+// Liefert den Allowlist-Index der Peer-Adresse oder -1. Wird im Acceptor
+// direkt nach accept() aufgerufen, bevor Speicher oder Threads belegt werden.
+int find_allowed_peer(struct in_addr addr) {
+    for (int i = 0; i < ALLOWED_PEER_COUNT; i++) {
+        if (allowed_peers[i].addr == addr.s_addr) {
+            return i;
+        }
     }
+    return -1;
 }
 
 // ========================================
-// CLIENT-AUTHENTIFIZIERUNG ÜBER NETZWERK
+// VERBINDUNGS-RATE-LIMIT PRO IP
 // ========================================
-// Authentifiziert den Client über Netzwerkkommunikation
-// Erwartet Benutzernamen und prüft ob er autorisiert ist
-// Wird in handle_client() verwendet, um sicherzustellen, dass nur autorisierte Clients Echtzeit-Threads starten können
-// Sendet Authentifizierungsaufforderung und empfängt Benutzernamen
-// Vergleicht den Benutzernamen mit dem autorisierten Benutzernamen
-int authenticate_network_client(int client_socket) {
-    char buffer[BUFFER_SIZE];
-    char username[MAX_USERNAME_LENGTH];
-    ssize_t bytes_received;
+// Token-Bucket: rate_limit Tokens pro Sekunde, maximal rate_burst gespeichert.
+// Jede neue Verbindung verbraucht ein Token. Gibt 1 zurück, wenn die
+// Verbindung zugelassen wird.
+int rate_limit_allow(int peer_index) {
+    allowed_peer_t* peer = &allowed_peers[peer_index];
+    struct timespec now;
+    int allowed = 0;
     
-    // Authentifizierungsaufforderung senden
-    const char* auth_prompt = "=== REMOTE AUTHENTICATION ===\nUsername: ";
-    if (send(client_socket, auth_prompt, strlen(auth_prompt), 0) < 0) {
-        perror("send auth_prompt");
-        return 0;
+    if (server_config.rate_limit <= 0.0) {
+        return 1;
     }
     
-    // Benutzername empfangen
-    memset(buffer, 0, sizeof(buffer));
-    bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-    if (bytes_received <= 0) {
-        printf("Fehler beim Empfangen des Benutzernamens\n");
-        return 0;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    pthread_mutex_lock(&rate_limit_mutex);
+    double elapsed = (now.tv_sec - peer->last_refill.tv_sec) +
+                     (now.tv_nsec - peer->last_refill.tv_nsec) / 1e9;
+    peer->tokens += elapsed * server_config.rate_limit;
+    if (peer->tokens > server_config.rate_burst) {
+        peer->tokens = server_config.rate_burst;
     }
+    peer->last_refill = now;
     
-    // Newline entfernen und in username kopieren
-    buffer[bytes_received] = '\0';
-    strncpy(username, buffer, sizeof(username) - 1);
-    username[sizeof(username) - 1] = '\0';
+    if (peer->tokens >= 1.0) {
+        peer->tokens -= 1.0;
+        allowed = 1;
+    }
+    pthread_mutex_unlock(&rate_limit_mutex);
     
-    // Newline am Ende entfernen
-    char* newline = strchr(username, '\n');
-    if (newline) *newline = '\0';
-    char* carriage = strchr(username, '\r');
-    if (carriage) *carriage = '\0';
+    return allowed;
+}
+
+// ========================================
+// BENUTZERDATENBANK: HASH-TABELLE
+// ========================================
+unsigned int user_hash(const char* name) {
+    unsigned int hash = 2166136261u;   // FNV-1a
+    for (; *name; name++) {
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const user_entry_t* find_user(const char* name) {
+    unsigned int slot = user_hash(name) & (USER_TABLE_SIZE - 1);
     
-    printf("Empfangener Benutzername: '%s'\n", username);
+    for (int probe = 0; probe < USER_TABLE_SIZE; probe++) {
+        const user_entry_t* entry = &user_table[(slot + probe) & (USER_TABLE_SIZE - 1)];
+        if (!entry->in_use) {
+            return NULL;
+        }
+        if (strcmp(entry->name, name) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int add_user(const user_entry_t* user) {
+    unsigned int slot = user_hash(user->name) & (USER_TABLE_SIZE - 1);
     
-    // Authentifizierung prüfen
-    if (strcmp(username, AUTHORIZED_USER) == 0) {
-        const char* success_msg = "✓ Authentication successful! RT access granted.\n";
-        send(client_socket, success_msg, strlen(success_msg), 0);
-        printf("✓ Client erfolgreich authentifiziert: %s\n", username);
-        return 1;
-    } else {
-        const char* error_msg = "✗ Authentication failed! Access denied.\n";
-        send(client_socket, error_msg, strlen(error_msg), 0);
-        printf("✗ Authentifizierung fehlgeschlagen für: %s\n", username);
+    // Halbvolle Tabelle als Obergrenze hält die Sondierungsketten kurz
+    if (user_count >= USER_TABLE_SIZE / 2) {
         return 0;
     }
+    for (int probe = 0; probe < USER_TABLE_SIZE; probe++) {
+        user_entry_t* entry = &user_table[(slot + probe) & (USER_TABLE_SIZE - 1)];
+        if (entry->in_use && strcmp(entry->name, user->name) == 0) {
+            return 0;   // Doppelter Eintrag
+        }
+        if (!entry->in_use) {
+            *entry = *user;
+            entry->in_use = 1;
+            user_count++;
+            return 1;
+        }
+    }
+    return 0;
 }
 
 // ========================================
-// ECHTZEIT-TASK FÜR CLIENT
+// BENUTZERDATENBANK LADEN
 // ========================================
-// Führt die Echtzeit-Operationen für einen verbundenen Client aus
-// Wird in einem separaten Thread für jeden Client gestartet
-// Simuliert eine Echtzeit-Task, die periodisch ausgeführt wird
-// Nutzt clock_nanosleep() für präzise Zeitsteuerung
-void* client_realtime_task(void* arg) {
-    client_info_t* client = (client_info_t*)arg;
-    struct timespec next_period, current_time;
-    int cycle_count = 0;
-    char message[BUFFER_SIZE];
-    
-    printf("Echtzeit-Thread gestartet für Client %s\n", client->client_ip);
+// Format pro Zeile (# = Kommentar):
+//   name max_sessions max_priority min_period_ms cpu_budget_percent
+// Fehlt die Standarddatei, gilt nur AUTHORIZED_USER mit den Standardquoten.
+int load_user_db(const char* path) {
+    char line[BUFFER_SIZE];
+    int line_number = 0;
+    FILE* file = fopen(path, "r");
     
-    // Timing initialisieren
-    if (clock_gettime(CLOCK_MONOTONIC, &next_period) != 0) {
-        perror("clock_gettime");
-        return NULL;
+    if (file == NULL && strcmp(path, DEFAULT_USER_DB) != 0) {
+        perror(path);   // Explizit angegebene Datenbank muss existieren
+        return 0;
+    }
+    if (file == NULL) {
+        user_entry_t fallback;
+        memset(&fallback, 0, sizeof(fallback));
+        strncpy(fallback.name, AUTHORIZED_USER, sizeof(fallback.name) - 1);
+        fallback.max_sessions = DEFAULT_MAX_SESSIONS;
+        fallback.max_priority = RT_PRIORITY;
+        fallback.min_period_ns = DEFAULT_MIN_PERIOD_MS * 1000000LL;
+        fallback.cpu_budget = DEFAULT_CPU_BUDGET_PERCENT / 100.0;
+        printf("Keine Benutzerdatenbank (%s), verwende Standardbenutzer '%s'\n", path, AUTHORIZED_USER);
+        return add_user(&fallback);
     }
     
-    // Startmeldung an Client senden
-    snprintf(message, sizeof(message), 
-             "=== REALTIME THREAD STARTED ===\nPriority: %d, Cycles: %d\n", 
-             RT_PRIORITY, MAX_CYCLES);
-    send(client->client_socket, message, strlen(message), 0);
-    
-    // Echtzeit-Hauptschleife
-    // Führt MAX_CYCLES Zyklen aus, jeder genau TASK_PERIOD_SEC Sekunden nach dem vorherigen
-    while (cycle_count < MAX_CYCLES && server_running) {
-        // Nächste Periode berechnen
-        next_period.tv_sec += TASK_PERIOD_SEC;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        user_entry_t user;
+        long min_period_ms;
+        double budget_percent;
+        char name[MAX_USERNAME_LENGTH];
         
-        // Präzise Wartezeit
-        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_period, NULL) != 0) {
-            if (errno != EINTR) {
-                perror("clock_nanosleep");
-                break;
-            }
+        line_number++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
         }
         
-        // Aktuelle Zeit messen
-        clock_gettime(CLOCK_MONOTONIC, &current_time);
-        
-        // RT-Task ausführen und an Client melden
-        cycle_count++;
-        snprintf(message, sizeof(message), 
-                "[Cycle %02d] RT-Task executed at %ld.%03ld for %s\n", 
-                cycle_count, 
-                current_time.tv_sec, 
-                current_time.tv_nsec / 1000000,
-                client->client_ip);
-        
-        printf("%s", message);  // Lokale Ausgabe
-        
-        // An Client senden (mit Fehlerbehandlung)
-        if (send(client->client_socket, message, strlen(message), MSG_NOSIGNAL) < 0) {
-            printf("Client %s getrennt, beende RT-Thread\n", client->client_ip);
-            break;
+        memset(&user, 0, sizeof(user));
+        if (sscanf(line, "%49s %d %d %ld %lf", name, &user.max_sessions, &user.max_priority,
+                   &min_period_ms, &budget_percent) != 5 ||
+            user.max_sessions < 1 || user.max_priority < 1 || user.max_priority > 99 ||
+            min_period_ms < 1 || budget_percent <= 0.0) {
+            printf("✗ %s:%d: ungültiger Eintrag\n", path, line_number);
+            fclose(file);
+            return 0;
         }
+        memcpy(user.name, name, sizeof(user.name));
+        user.min_period_ns = min_period_ms * 1000000LL;
+        user.cpu_budget = budget_percent / 100.0;
         
-        // Deterministische Arbeitslast simulieren
-        for (volatile int i = 0; i < 100000; i++);
+        if (!add_user(&user)) {
+            printf("✗ %s:%d: Benutzer '%s' doppelt oder Tabelle voll\n", path, line_number, name);
+            fclose(file);
+            return 0;
+        }
     }
     
-    // Abschlussmeldung
-    snprintf(message, sizeof(message), 
-             "=== RT-THREAD COMPLETED ===\nExecuted %d cycles\n", cycle_count);
-    send(client->client_socket, message, strlen(message), MSG_NOSIGNAL);
-    
-    printf("Echtzeit-Thread beendet für Client %s nach %d Zyklen\n", 
-           client->client_ip, cycle_count);
-    
-    return NULL;
+    fclose(file);
+    printf("Benutzerdatenbank %s: %d Benutzer geladen\n", path, user_count);
+    return user_count > 0;
 }
 
 // ========================================
-// CLIENT-HANDLER-THREAD
+// ADMISSION CONTROL
 // ========================================
-// Hinweis: Der Pointer 'client' MUSS mit malloc() alloziert werden!
-// Niemals einen stack-allozierten oder wiederverwendeten Pointer übergeben!
-void* handle_client(void* arg) {
-    client_info_t* client = (client_info_t*)arg;
-    pthread_t rt_thread;
-    struct sched_param param;
-    pthread_attr_t attr;
-    int ret;
-    
-    printf("\n=== NEUER CLIENT ===\n");
-    printf("Client verbunden von IP: %s\n", client->client_ip);
+// Prüft die Quoten des Benutzers und die Gesamtkapazität der RT-CPUs.
+// Die Auslastung einer laufenden Sitzung ist max(Reservierung, gemessen),
+// gemessen = CPU-Zeit pro Zyklus (aus dem Seqlock) / Periode. Eine neue
+// Sitzung wird mit den höchsten gemessenen Zykluskosten aller laufenden
+// Sitzungen geschätzt (DEFAULT_CYCLE_COST_US, solange nichts gemessen ist).
+// Gibt 1 zurück und reserviert, oder 0 mit Begründung in reason.
+int admit_session(client_info_t* client, char* reason, size_t reason_size) {
+    const user_entry_t* user = client->user;
+    double capacity = server_config.rt_cpus * RT_UTILIZATION_LIMIT;
+    long long cost_estimate_ns = DEFAULT_CYCLE_COST_US * 1000LL;
+    double total_util = 0.0;
+    double user_util = 0.0;
+    int user_sessions = 0;
+    int admitted = 0;
     
-    // 1. IP-Autorisierung prüfen
-    if (!check_client_ip_authorization(client->client_ip)) {
-        const char* ip_error = "✗ IP address not authorized. Connection refused.\n";
-        send(client->client_socket, ip_error, strlen(ip_error), 0);
-        printf("Verbindung zu %s aus Sicherheitsgründen abgelehnt\n", client->client_ip);
-        goto cleanup;
+    if (client->priority < 1 || client->priority > user->max_priority) {
+        snprintf(reason, reason_size, "priority %d not allowed (max %d)",
+                 client->priority, user->max_priority);
+        return 0;
     }
-    
-    // 2. Client-Authentifizierung
-    if (!authenticate_network_client(client->client_socket)) {
-        printf("Authentifizierung für %s fehlgeschlagen\n", client->client_ip);
-        goto cleanup;
+    if (client->period_ns < user->min_period_ns) {
+        snprintf(reason, reason_size, "period %lld ms below minimum %lld ms",
+                 client->period_ns / 1000000, user->min_period_ns / 1000000);
+        return 0;
     }
     
-    client->authenticated = 1;
-    printf("Client %s vollständig autorisiert\n", client->client_ip);
-    
-    // 3. Echtzeit-Thread-Attribute konfigurieren
-    ret = pthread_attr_init(&attr);
-    if (ret == 0) {
-        ret = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
-        if (ret == 0) {
-            param.sched_priority = RT_PRIORITY;
-            ret = pthread_attr_setschedparam(&attr, &param);
-            if (ret == 0) {
-                pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
-            }
+    pthread_mutex_lock(&session_mutex);
+    for (int i = 0; i < session_count; i++) {
+        rt_state_t snap;
+        if (sessions[i]->admitted && rt_state_read(&sessions[i]->published, &snap) &&
+            snap.cycle_cpu_avg_ns > cost_estimate_ns) {
+            cost_estimate_ns = snap.cycle_cpu_avg_ns;
         }
     }
     
-    // 4. Echtzeit-Thread für Client starten
-    if (ret == 0) {
-        ret = pthread_create(&rt_thread, &attr, client_realtime_task, client);
+    for (int i = 0; i < session_count; i++) {
+        client_info_t* other = sessions[i];
+        rt_state_t snap;
+        double util;
+        
+        if (!other->admitted) {
+            continue;
+        }
+        util = other->reserved_util;
+        if (rt_state_read(&other->published, &snap) &&
+            (double)snap.cycle_cpu_avg_ns / other->period_ns > util) {
+            util = (double)snap.cycle_cpu_avg_ns / other->period_ns;
+        }
+        total_util += util;
+        if (other->user == user) {
+            user_util += util;
+            user_sessions++;
+        }
     }
     
-    if (ret != 0) {
-        printf("RT-Thread-Erstellung fehlgeschlagen: %s\n", strerror(ret));
-        // Fallback: Normaler Thread
-        if (pthread_create(&rt_thread, NULL, client_realtime_task, client) != 0) {
-            perror("pthread_create fallback");
-            const char* error_msg = "✗ Failed to start RT thread\n";
-            send(client->client_socket, error_msg, strlen(error_msg), 0);
-            goto cleanup;
-        } else {
-            printf("Normaler Thread erstellt für Client %s\n", client->client_ip);
-        }
+    double new_util = (double)cost_estimate_ns / client->period_ns;
+    
+    if (user_sessions >= user->max_sessions) {
+        snprintf(reason, reason_size, "session limit reached (%d)", user->max_sessions);
+    } else if (user_util + new_util > user->cpu_budget) {
+        snprintf(reason, reason_size, "CPU budget exceeded (%.2f%% + %.2f%% > %.2f%%)",
+                 user_util * 100.0, new_util * 100.0, user->cpu_budget * 100.0);
+    } else if (total_util + new_util > capacity) {
+        snprintf(reason, reason_size, "RT cores saturated (%.2f%% + %.2f%% > %.2f%%)",
+                 total_util * 100.0, new_util * 100.0, capacity * 100.0);
     } else {
-        printf("Echtzeit-Thread erstellt für Client %s (Priorität: %d)\n", 
-               client->client_ip, RT_PRIORITY);
+        client->reserved_util = new_util;
+        client->admitted = 1;
+        admitted = 1;
+        snprintf(reason, reason_size, "reserved %.3f%% CPU", new_util * 100.0);
     }
+    pthread_mutex_unlock(&session_mutex);
     
-    // 5. Auf Thread-Beendigung warten
-    pthread_join(rt_thread, NULL);
-    pthread_attr_destroy(&attr);
-    
-cleanup:
-    printf("Client %s getrennt\n", client->client_ip);
-    close(client->client_socket);
-    free(client);
-    return NULL;
+    return admitted;
 }
 
 // ========================================
-// MAIN SERVER FUNCTION
+// SITZUNGSANFRAGE PARSEN
 // ========================================
-int main() {
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_addr_len;
-    int client_socket;
-    pthread_t client_thread;
-    int opt = 1;
-    
-    printf("=== SECURE REALTIME SERVER ===\n");
-    printf("Port: %d\n", SERVER_PORT);
-    printf("Autorisierte Client-IPs: %s, %s\n", AUTHORIZED_IP, ALTERNATIVE_IP);
-    printf("Für STRG+C zum Beenden\n\n");
-    
-    // Signal-Handler registrieren
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
+// Anmeldezeile: "<username> [priority=N] [period_ms=N]"
+// Ohne Angaben gelten RT_PRIORITY bzw. TASK_PERIOD_SEC, begrenzt auf die
+// Quoten des Benutzers (Kompatibilität mit Clients, die nur den Namen senden).
+// *given meldet, welche Werte explizit angefragt wurden (REQUEST_* Bits):
+// Nur diese prüft die Admission Control unverändert gegen die Quote.
+#define REQUEST_PRIORITY 0x1
+#define REQUEST_PERIOD   0x2
+
+int parse_session_request(char* line, char* username, size_t username_size,
+                          int* priority, long long* period_ns, int* given) {
+    char* saveptr = NULL;
+    *given = 0;
+    char* token = strtok_r(line, " \t", &saveptr);
     
-    // Memory-Locking für RT-Performance
-    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
-        printf("Warnung: Memory-Locking fehlgeschlagen: %s\n", strerror(errno));
-    } else {
-        printf("Memory-Locking erfolgreich aktiviert\n");
+    if (token == NULL) {
+        username[0] = '\0';
+        return 1;
     }
+    strncpy(username, token, username_size - 1);
+    username[username_size - 1] = '\0';
     
-    // 1. Socket erstellen
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_socket < 0) {
-        perror("socket");
-        return EXIT_FAILURE;
+    while ((token = strtok_r(NULL, " \t", &saveptr)) != NULL) {
+        long value;
+        if (sscanf(token, "priority=%ld", &value) == 1) {
+            *priority = (int)value;
+            *given |= REQUEST_PRIORITY;
+        } else if (sscanf(token, "period_ms=%ld", &value) == 1 && value > 0) {
+            *period_ns = value * 1000000LL;
+            *given |= REQUEST_PERIOD;
+        } else {
+            return 0;
+        }
     }
-    
-    // Socket-Optionen setzen (Adresse wiederverwenden)
-    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        perror("setsockopt");
-        close(server_socket);
-        return EXIT_FAILURE;
+    return 1;
+}
+
+// ========================================
+// TLS-KANAL MIT KERNEL-OFFLOAD (kTLS)
+// ========================================
+// Der TLS-1.3-Handshake läuft in OpenSSL (im Handshake-Reaktor). Mit
+// SSL_OP_ENABLE_KTLS übergibt OpenSSL danach die Schlüssel per
+// setsockopt(SOL_TLS, TLS_TX/TLS_RX) an den Kernel: Der RT-Thread sendet
+// weiter mit send() auf dem Socket, der Kernel verschlüsselt die Records -
+// keine zusätzliche Kopie im Nutzerraum. Ohne kTLS-Unterstützung (Modul
+// "tls" fehlt, Cipher nicht unterstützt) fällt die Sitzung auf SSL_write() zurück.
+int init_tls(const char* cert_path, const char* key_path) {
+    tls_ctx = SSL_CTX_new(TLS_server_method());
+    if (tls_ctx == NULL ||
+        !SSL_CTX_set_min_proto_version(tls_ctx, TLS1_3_VERSION) ||
+        SSL_CTX_use_certificate_chain_file(tls_ctx, cert_path) != 1 ||
+        SSL_CTX_use_PrivateKey_file(tls_ctx, key_path, SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(tls_ctx) != 1) {
+        printf("✗ TLS-Initialisierung fehlgeschlagen (%s, %s)\n", cert_path, key_path);
+        ERR_print_errors_fp(stdout);
+        SSL_CTX_free(tls_ctx);
+        tls_ctx = NULL;
+        return 0;
     }
     
-    // 2. Server-Adresse konfigurieren
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET; // IPv4   
-    server_addr.sin_addr.s_addr = INADDR_ANY;  // Alle verfügbaren Interfaces
-    server_addr.sin_port = htons(SERVER_PORT); // Port in Netzwerk-Byte-Reihenfolge
+    // Nur Cipher, die der Kernel offloaden kann
+    SSL_CTX_set_ciphersuites(tls_ctx, "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:"
+                                      "TLS_CHACHA20_POLY1305_SHA256");
+    SSL_CTX_set_options(tls_ctx, SSL_OP_ENABLE_KTLS);
+    // Keine Session-Tickets: nach dem Handshake fließen nur noch Anwendungsdaten
+    SSL_CTX_set_num_tickets(tls_ctx, 0);
     
-    // 3. Socket an Port binden
-    if (bind(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        perror("bind");
-        close(server_socket);
-        return EXIT_FAILURE;
+    // SSL_write() kennt kein MSG_NOSIGNAL
+    signal(SIGPIPE, SIG_IGN);
+    return 1;
+}
+
+// Ein Schritt des nicht-blockierenden Handshakes: 1 = fertig, 0 = läuft, -1 = Fehler.
+// *want_write meldet, dass OpenSSL auf POLLOUT wartet.
+int tls_accept_step(client_info_t* client, int* want_write) {
+    int ret = SSL_accept(client->ssl);
+    
+    *want_write = 0;
+    if (ret == 1) {
+        client->ktls_tx = BIO_get_ktls_send(SSL_get_wbio(client->ssl));
+        client->ktls_rx = BIO_get_ktls_recv(SSL_get_rbio(client->ssl));
+        printf("TLS für %s: %s, %s, kTLS TX %s, RX %s\n", client->client_ip,
+               SSL_get_version(client->ssl), SSL_get_cipher_name(client->ssl),
+               client->ktls_tx ? "aktiv" : "nicht verfügbar (SSL_write)",
+               client->ktls_rx ? "aktiv" : "nicht verfügbar (SSL_read)");
+        return 1;
     }
-    printf("Server gebunden an Port %d\n", SERVER_PORT);
     
-    // 4. Auf Verbindungen lauschen
-    if (listen(server_socket, MAX_CLIENTS) < 0) {
-        perror("listen");
-        close(server_socket);
-        return EXIT_FAILURE;
+    switch (SSL_get_error(client->ssl, ret)) {
+    case SSL_ERROR_WANT_READ:
+        return 0;
+    case SSL_ERROR_WANT_WRITE:
+        *want_write = 1;
+        return 0;
+    default:
+        printf("✗ TLS-Handshake mit %s fehlgeschlagen\n", client->client_ip);
+        ERR_clear_error();
+        return -1;
     }
+}
 
-    printf("Server lauscht auf Port %d...\n", SERVER_PORT);
-    
-    
-    // 5. Client-Verbindungen akzeptieren
-    // Hauptschleife: Akzeptiert Verbindungen solange der Server läuft (server_running == 1)
-    printf("Warte auf Client-Verbindungen...\n");
-    while (server_running) {
-        client_addr_len = sizeof(client_addr);
-        client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_addr_len);
-        
-        
-        if (client_socket < 0) {
-            if (server_running) {  // Nur Fehler ausgeben wenn Server noch läuft
-                perror("accept");
+// Sendet auf dem Sitzungskanal: Klartext und kTLS per send(), sonst SSL_write()
+// Der Handover-Weckruf (SIGUSR1, ohne SA_RESTART) unterbricht auch ein
+// blockiertes send()/SSL_write(): Dann wiederholen, sonst endet die Sitzung,
+// statt für den Handover zu parken.
+ssize_t session_send(client_info_t* client, const void* data, size_t len) {
+    if (client->ssl == NULL || client->ktls_tx) {
+        size_t done = 0;
+        while (done < len) {
+            ssize_t n = send(client->client_socket, (const char*)data + done, len - done, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
             }
-            continue;
+            done += n;
+        }
+        return (ssize_t)done;
+    }
+    for (;;) {
+        int n = SSL_write(client->ssl, data, (int)len);
+        if (n > 0) {
+            return n;
+        }
+        int err = SSL_get_error(client->ssl, n);
+        if ((err == SSL_ERROR_WANT_WRITE || err == SSL_ERROR_WANT_READ || err == SSL_ERROR_SYSCALL) &&
+            errno == EINTR) {
+            continue;   // Gleicher Puffer, wie von SSL_write() verlangt
+        }
+        ERR_clear_error();
+        return -1;
+    }
+}
+
+// Empfängt wie recv(); bei TLS ohne Daten errno = EAGAIN
+ssize_t session_recv(client_info_t* client, void* data, size_t len) {
+    if (client->ssl == NULL) {
+        return recv(client->client_socket, data, len, 0);
+    }
+    int n = SSL_read(client->ssl, data, (int)len);
+    if (n > 0) {
+        return n;
+    }
+    switch (SSL_get_error(client->ssl, n)) {
+    case SSL_ERROR_WANT_READ:
+    case SSL_ERROR_WANT_WRITE:
+        errno = EAGAIN;
+        return -1;
+    case SSL_ERROR_ZERO_RETURN:
+        return 0;
+    default:
+        ERR_clear_error();
+        errno = ECONNRESET;
+        return -1;
+    }
+}
+
+// ========================================
+// CLIENT-AUTHENTIFIZIERUNG ÜBER NETZWERK
+// ========================================
+// Authentifiziert den Client anhand seiner Anmeldezeile
+// Erwartet Benutzernamen und prüft ob er in der Benutzerdatenbank steht
+// Wird vom Handshake-Reaktor aufgerufen, sobald die Zeile vollständig ist, damit nur autorisierte Clients Echtzeit-Threads starten können
+// Die Zeile enthält den Benutzernamen (optional mit Priorität/Periode)
+// Danach entscheidet die Admission Control anhand der Benutzerquoten und der RT-Auslastung
+int authenticate_network_client(client_info_t* client, char* request) {
+    char buffer[BUFFER_SIZE];
+    char username[MAX_USERNAME_LENGTH];
+    char reason[128];
+    
+    // Carriage Return am Ende entfernen (Newline hat der Reaktor bereits entfernt)
+    char* carriage = strchr(request, '\r');
+    if (carriage) *carriage = '\0';
+    
+    // Benutzername und gewünschte RT-Parameter
+    client->priority = RT_PRIORITY;
+    client->period_ns = TASK_PERIOD_SEC * 1000000000LL;
+    int given;
+    int request_ok = parse_session_request(request, username, sizeof(username),
+                                           &client->priority, &client->period_ns, &given);
+    
+    printf("Empfangener Benutzername: '%s'\n", username);
+    
+    // Authentifizierung prüfen
+    client->user = request_ok ? find_user(username) : NULL;
+    if (client->user == NULL) {
+        const char* error_msg = "✗ Authentication failed! Access denied.\n";
+        session_send(client, error_msg, strlen(error_msg));
+        printf("✗ Authentifizierung fehlgeschlagen für: %s\n", username);
+        return 0;
+    }
+    
+    // Nur nicht angefragte Defaults auf die Quoten begrenzen; explizite Werte
+    // außerhalb der Quote lehnt die Admission Control ab
+    if (!(given & REQUEST_PRIORITY) && client->priority > client->user->max_priority) {
+        client->priority = client->user->max_priority;
+    }
+    if (!(given & REQUEST_PERIOD) && client->period_ns < client->user->min_period_ns) {
+        client->period_ns = client->user->min_period_ns;
+    }
+    
+    // Admission Control
+    if (!admit_session(client, reason, sizeof(reason))) {
+        snprintf(buffer, sizeof(buffer), "✗ Admission failed: %s\n", reason);
+        session_send(client, buffer, strlen(buffer));
+        printf("✗ Sitzung für %s abgelehnt: %s\n", username, reason);
+        return 0;
+    }
+    
+    const char* success_msg = "✓ Authentication successful! RT access granted.\n";
+    session_send(client, success_msg, strlen(success_msg));
+    printf("✓ Client erfolgreich authentifiziert: %s (Priorität %d, Periode %lld ms, %s)\n",
+           username, client->priority, client->period_ns / 1000000, reason);
+    return 1;
+}
+
+// ========================================
+// ZEITHILFEN
+// ========================================
+double timespec_diff_ms(const struct timespec* a, const struct timespec* b) {
+    return (a->tv_sec - b->tv_sec) * 1000.0 + (a->tv_nsec - b->tv_nsec) / 1e6;
+}
+
+long long timespec_to_ns(const struct timespec* t) {
+    return (long long)t->tv_sec * 1000000000LL + t->tv_nsec;
+}
+
+void timespec_add_ns(struct timespec* t, long long ns) {
+    ns += t->tv_nsec;
+    t->tv_sec += ns / 1000000000LL;
+    t->tv_nsec = ns % 1000000000LL;
+}
+
+// ========================================
+// UHRENABGLEICH FÜR LATENZMESSUNG
+// ========================================
+// Nach der Anmeldung kann der Client bis zu MAX_CLOCK_SYNC_SAMPLES Pings
+// "SYNC <t1>" senden; der Server antwortet sofort mit "SYNC <t1> <t2>"
+// (t2 = CLOCK_MONOTONIC in ns). Daraus schätzt der Client den Uhren-Offset
+// (NTP-Verfahren). "SYNC DONE" oder CLOCK_SYNC_WINDOW_MS Stille beendet die
+// Phase - ältere Clients ohne Pings verzögern den RT-Start nur um das Fenster.
+// Verarbeitet eine Zeile: 1 = Ping beantwortet, -1 = SYNC DONE, 0 = ignoriert
+int answer_clock_sync(client_info_t* client, const char* line) {
+    struct timespec now;
+    long long t1;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (strncmp(line, "SYNC DONE", 9) == 0) {
+        return -1;
+    } else if (sscanf(line, "SYNC %lld", &t1) == 1) {
+        char reply[64];
+        snprintf(reply, sizeof(reply), "SYNC %lld %lld\n", t1, timespec_to_ns(&now));
+        session_send(client, reply, strlen(reply));
+        return 1;
+    }
+    return 0;
+}
+
+// ========================================
+// KERNEL-TX-ZEITSTEMPEL (SO_TIMESTAMPING)
+// ========================================
+// Aktiviert Software-TX-Zeitstempel: Der Kernel meldet über die Error-Queue,
+// wann das Segment an den Netzwerktreiber übergeben wurde (CLOCK_REALTIME).
+int enable_tx_timestamps(int client_socket) {
+    int flags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+    
+    if (setsockopt(client_socket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        perror("setsockopt SO_TIMESTAMPING");
+        return 0;
+    }
+    return 1;
+}
+
+// Liest alle anstehenden TX-Zeitstempel (nicht-blockierend) und verbucht die
+// Verzögerung zwischen send()-Aufruf und Übergabe an den Treiber
+void collect_tx_timestamps(client_info_t* client) {
+    char control[256];
+    struct msghdr msg;
+    
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        
+        if (recvmsg(client->client_socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;   // EAGAIN: keine weiteren Zeitstempel
+        }
+        
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                struct scm_timestamping* tss = (struct scm_timestamping*)CMSG_DATA(cmsg);
+                long long delay = timespec_to_ns(&tss->ts[0]) - timespec_to_ns(&client->last_send_realtime);
+                if (delay >= 0) {
+                    client->tx_stamp_count++;
+                    client->tx_delay_sum_ns += delay;
+                    if (delay > client->tx_delay_max_ns) {
+                        client->tx_delay_max_ns = delay;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ========================================
+// SIMULATIONSSTATISTIK
+// ========================================
+// Jede simulierte Sitzung trägt am Ende ihre Werte ein. Die Prüfsumme ist die
+// Summe der Sitzungs-Prüfsummen und damit unabhängig von der Reihenfolge, in
+// der die Threads enden. Nur im Simulationsmodus benutzt, daher ohne PI-Mutex.
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned long sessions;
+    unsigned long cycles;
+    unsigned long overruns;
+    long long lateness_sum_ns;
+    long long lateness_max_ns;
+    uint64_t digest;
+} sim_stats_t;
+
+sim_stats_t sim_stats = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+void sim_collect(const client_info_t* client) {
+    pthread_mutex_lock(&sim_stats.lock);
+    sim_stats.sessions++;
+    sim_stats.cycles += client->cycle_count;
+    sim_stats.overruns += client->overrun_count;
+    sim_stats.lateness_sum_ns += client->lateness_sum_ns;
+    if (client->rt_state.max_lateness_ns > sim_stats.lateness_max_ns) {
+        sim_stats.lateness_max_ns = client->rt_state.max_lateness_ns;
+    }
+    sim_stats.digest += client->lateness_digest;
+    pthread_mutex_unlock(&sim_stats.lock);
+}
+
+// ========================================
+// ECHTZEIT-TASK FÜR CLIENT
+// ========================================
+// Führt die Echtzeit-Operationen für einen verbundenen Client aus
+// Wird in einem separaten Thread für jeden Client gestartet
+// Simuliert eine Echtzeit-Task, die periodisch ausgeführt wird
+// Nutzt clock_nanosleep() für präzise Zeitsteuerung (über rt_clock, im
+// Simulationsmodus virtuell: kein Warten, Arbeitslast per rt_clock_consume())
+//
+// Bei handover_requested parkt der Thread vor dem nächsten Zyklus; next_period
+// bleibt dabei unverbraucht, sodass der Nachfolger exakt auf dem Raster weiterläuft
+void* client_realtime_task(void* arg) {
+    client_info_t* client = (client_info_t*)arg;
+    struct timespec current_time, send_time, cpu_start, cpu_end;
+    char message[BUFFER_SIZE];
+    int ret;
+    int tx_timestamps = 0;
+    
+    printf("Echtzeit-Thread gestartet für Client %s\n", client->client_ip);
+    client->rt_state.active = 1;
+    client->rt_state.cycle_count = client->cycle_count;
+    
+    // Timing initialisieren (übernommene Sitzungen behalten ihr Raster)
+    if (!client->resumed) {
+        if (rt_clock_now(rt_clock, &client->next_period) != 0) {
+            perror("clock_gettime");
+            rt_clock_detach(rt_clock);
+            return NULL;
+        }
+        timespec_add_ns(&client->next_period, client->period_ns);
+    }
+    
+    // Startmeldung an Client senden
+    if (!client->started) {
+        snprintf(message, sizeof(message), 
+                 "=== REALTIME THREAD STARTED ===\nPriority: %d, Cycles: %d\n", 
+                 client->priority, server_config.cycles);
+        session_send(client, message, strlen(message));
+        client->started = 1;
+    }
+    
+    // TX-Zeitstempel erst ab hier: nur die Zyklus-Meldungen werden vermessen
+    if (server_config.tx_timestamps) {
+        tx_timestamps = enable_tx_timestamps(client->client_socket);
+    }
+    
+    // Echtzeit-Hauptschleife
+    // Führt server_config.cycles Zyklen aus, jeder genau period_ns nach dem vorherigen
+    while (client->cycle_count < server_config.cycles && server_running) {
+        if (handover_requested) {
+            client->parked = 1;
+            break;
+        }
+        
+        // Präzise Wartezeit
+        ret = rt_clock_sleep_until(rt_clock, &client->next_period, &client->jitter_state,
+                                   client->priority, client->sim_index);
+        if (ret == EINTR) {
+            continue;   // Handover-Weckruf oder anderes Signal: Flags neu prüfen
+        } else if (ret != 0) {
+            printf("clock_nanosleep: %s\n", strerror(ret));
+            break;
+        }
+        
+        // Aktuelle Zeit und CPU-Zeit des Threads messen (Zykluskosten für Admission Control)
+        rt_clock_now(rt_clock, &current_time);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+        
+        // Erster Zyklus nach Handover: Abweichung vom Raster und Gesamtlücke melden
+        if (client->resumed == 1) {
+            printf("Handover-Lücke für %s: %.3f ms seit Einfrieren, %.3f ms Verspätung zum Raster\n",
+                   client->client_ip,
+                   timespec_diff_ms(&current_time, &client->freeze_time),
+                   timespec_diff_ms(&current_time, &client->next_period));
+            client->resumed = 2;
+        }
+        
+        // Lateness gegenüber dem Raster (vor dem Weiterschalten von next_period)
+        long long lateness = timespec_to_ns(&current_time) - timespec_to_ns(&client->next_period);
+        
+        // RT-Task ausführen und an Client melden
+        // tx_ns = CLOCK_MONOTONIC unmittelbar vor dem send(), Basis der
+        // Einweg-Latenzmessung im Client
+        client->cycle_count++;
+        if (tx_timestamps) {
+            collect_tx_timestamps(client);   // Verspätete Zeitstempel des Vorzyklus
+            clock_gettime(CLOCK_REALTIME, &client->last_send_realtime);
+        }
+        rt_clock_now(rt_clock, &send_time);
+        snprintf(message, sizeof(message), 
+                "[Cycle %02d] RT-Task executed at %ld.%03ld for %s tx_ns=%lld\n", 
+                client->cycle_count, 
+                current_time.tv_sec, 
+                current_time.tv_nsec / 1000000,
+                client->client_ip,
+                timespec_to_ns(&send_time));
+        
+        // An Client senden (mit Fehlerbehandlung)
+        int sent = session_send(client, message, strlen(message)) >= 0;
+        
+        // Zustand veröffentlichen (blockiert nie, auch nicht bei lesendem Metrik-Thread)
+        client->rt_state.cycle_count = client->cycle_count;
+        client->rt_state.last_cycle_ns = timespec_to_ns(&current_time);
+        client->rt_state.next_deadline_ns = timespec_to_ns(&client->next_period) + client->period_ns;
+        client->rt_state.last_lateness_ns = lateness;
+        if (lateness > client->rt_state.max_lateness_ns) {
+            client->rt_state.max_lateness_ns = lateness;
+        }
+        if (!sent) {
+            client->rt_state.send_errors++;
+        }
+        rt_state_publish(&client->published, &client->rt_state);
+        
+        if (!sent) {
+            printf("Client %s getrennt, beende RT-Thread\n", client->client_ip);
+            break;
+        }
+        if (tx_timestamps) {
+            collect_tx_timestamps(client);
+        }
+        
+        // Deterministische Arbeitslast simulieren
+        if (rt_clock->simulated) {
+            // Virtuell: keine Ausgabe pro Zyklus, Arbeitslast als simulierte Zeit
+            client->lateness_digest = rt_clock_digest(client->lateness_digest, lateness);
+            client->lateness_sum_ns += lateness;
+            if (lateness > client->period_ns) {
+                client->overrun_count++;
+            }
+            rt_clock_consume(rt_clock, server_config.sim_cost_us * 1000LL,
+                             client->priority, client->sim_index);
+        } else {
+            printf("%s", message);  // Lokale Ausgabe (nach send(), außerhalb der Messstrecke)
+            for (volatile int i = 0; i < 100000; i++);
+        }
+        
+        // CPU-Kosten des Zyklus; werden mit dem nächsten Zyklus veröffentlicht
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+        long long cpu_ns = timespec_to_ns(&cpu_end) - timespec_to_ns(&cpu_start);
+        if (client->rt_state.cycle_cpu_avg_ns == 0) {
+            client->rt_state.cycle_cpu_avg_ns = cpu_ns;
+        } else {
+            client->rt_state.cycle_cpu_avg_ns +=
+                (cpu_ns - client->rt_state.cycle_cpu_avg_ns) >> CPU_COST_EWMA_SHIFT;
+        }
+        if (cpu_ns > client->rt_state.cycle_cpu_max_ns) {
+            client->rt_state.cycle_cpu_max_ns = cpu_ns;
+        }
+        
+        // Nächste Periode berechnen
+        timespec_add_ns(&client->next_period, client->period_ns);
+    }
+    
+    if (tx_timestamps) {
+        collect_tx_timestamps(client);   // Letzte Zeitstempel vor der Abschlussmeldung
+    }
+    
+    client->rt_state.active = 0;
+    rt_state_publish(&client->published, &client->rt_state);
+    rt_clock_detach(rt_clock);   // Virtuelle Uhr wartet nicht mehr auf diesen Thread
+    if (rt_clock->simulated) {
+        sim_collect(client);
+    }
+    
+    if (client->parked) {
+        printf("Echtzeit-Thread für %s nach %d Zyklen für Handover geparkt\n",
+               client->client_ip, client->cycle_count);
+        return NULL;
+    }
+    
+    // Abschlussmeldung
+    snprintf(message, sizeof(message), 
+             "=== RT-THREAD COMPLETED ===\nExecuted %d cycles\n", client->cycle_count);
+    session_send(client, message, strlen(message));
+    
+    printf("Echtzeit-Thread beendet für Client %s nach %d Zyklen\n", 
+           client->client_ip, client->cycle_count);
+    
+    if (tx_timestamps) {
+        if (client->tx_stamp_count > 0) {
+            printf("TX-Zeitstempel %s: %lu, send()->Treiber avg %.1f us, max %.1f us\n",
+                   client->client_ip, client->tx_stamp_count,
+                   client->tx_delay_sum_ns / 1000.0 / client->tx_stamp_count,
+                   client->tx_delay_max_ns / 1000.0);
+        }
+    }
+    
+    return NULL;
+}
+
+// Einstieg des RT-Threads: Das Ende wird vor dem Rücksprung gemeldet, damit der
+// Handler die Sitzung aus SESSION_RUNNING nimmt, solange die Thread-ID noch
+// gültig ist (pthread_kill() auf einen gejointen Thread ist undefiniert)
+void* client_rt_thread(void* arg) {
+    client_info_t* client = (client_info_t*)arg;
+    client_realtime_task(client);
+    sem_post(&client->rt_exited);
+    return NULL;
+}
+
+// ========================================
+// CLIENT-HANDLER-THREAD
+// ========================================
+// Startet den RT-Thread einer fertig angemeldeten (Handshake-Reaktor) oder
+// übernommenen (Handover) Sitzung. Die Sitzung ist bereits registriert.
+// Hinweis: Der Pointer 'client' MUSS mit malloc() alloziert werden!
+// Niemals einen stack-allozierten oder wiederverwendeten Pointer übergeben!
+void* handle_client(void* arg) {
+    client_info_t* client = (client_info_t*)arg;
+    pthread_t rt_thread;
+    struct sched_param param;
+    pthread_attr_t attr;
+    int ret;
+    
+    if (client->resumed) {
+        // Übernommene Sitzung: IP und Benutzer wurden im Vorgänger geprüft
+        printf("\n=== ÜBERNOMMENE SITZUNG ===\n");
+        printf("Client %s fortgesetzt ab Zyklus %d\n", client->client_ip, client->cycle_count);
+    } else {
+        // IP (Acceptor), Benutzer, Admission und Uhrenabgleich (Reaktor) sind erledigt
+        printf("Client %s vollständig autorisiert\n", client->client_ip);
+    }
+    
+    // Handover läuft bereits: Sitzung ohne RT-Thread parken, der Nachfolger startet sie
+    pthread_mutex_lock(&session_mutex);
+    if (handover_requested) {
+        clock_gettime(CLOCK_MONOTONIC, &client->next_period);
+        timespec_add_ns(&client->next_period, client->period_ns);
+        client->state = SESSION_PARKED;
+        pthread_mutex_unlock(&session_mutex);
+        return NULL;
+    }
+    pthread_mutex_unlock(&session_mutex);
+    
+    // 4. Echtzeit-Thread-Attribute konfigurieren (Simulation: normaler Thread)
+    ret = pthread_attr_init(&attr);
+    if (ret == 0 && !rt_clock->simulated) {
+        ret = pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        if (ret == 0) {
+            param.sched_priority = client->priority;
+            ret = pthread_attr_setschedparam(&attr, &param);
+            if (ret == 0) {
+                pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            }
+        }
+    }
+    
+    // 5. Echtzeit-Thread für Client starten
+    if (ret == 0) {
+        ret = pthread_create(&rt_thread, &attr, client_rt_thread, client);
+    }
+    
+    if (ret != 0) {
+        printf("RT-Thread-Erstellung fehlgeschlagen: %s\n", strerror(ret));
+        // Fallback: Normaler Thread
+        if (pthread_create(&rt_thread, NULL, client_rt_thread, client) != 0) {
+            perror("pthread_create fallback");
+            rt_clock_detach(rt_clock);   // Angemeldeter Teilnehmer läuft nie
+            const char* error_msg = "✗ Failed to start RT thread\n";
+            session_send(client, error_msg, strlen(error_msg));
+            goto cleanup;
+        } else {
+            printf("Normaler Thread erstellt für Client %s\n", client->client_ip);
+        }
+    } else {
+        printf("Echtzeit-Thread erstellt für Client %s (Priorität: %d)\n", 
+               client->client_ip, client->priority);
+    }
+    
+    pthread_mutex_lock(&session_mutex);
+    client->thread_id = rt_thread;
+    client->state = SESSION_RUNNING;
+    pthread_mutex_unlock(&session_mutex);
+    
+    // 6. Auf Thread-Beendigung warten
+    // Erst unter session_mutex aus SESSION_RUNNING nehmen, dann joinen: Der
+    // Handover-Thread signalisiert nur Sitzungen in SESSION_RUNNING
+    while (sem_wait(&client->rt_exited) != 0 && errno == EINTR);
+    pthread_mutex_lock(&session_mutex);
+    client->state = client->parked ? SESSION_PARKED : SESSION_CLOSING;
+    pthread_mutex_unlock(&session_mutex);
+    pthread_join(rt_thread, NULL);
+    pthread_attr_destroy(&attr);
+    
+    // Geparkte Sitzung gehört ab jetzt dem Handover-Thread
+    if (client->parked) {
+        return NULL;
+    }
+    
+cleanup:
+    pthread_mutex_lock(&session_mutex);
+    unregister_session_locked(client);
+    pthread_mutex_unlock(&session_mutex);
+    printf("Client %s getrennt\n", client->client_ip);
+    free_client_info(client);
+    return NULL;
+}
+
+// ========================================
+// CLIENT-INFO ANLEGEN
+// ========================================
+// Legt eine neue Sitzung im Zustand SESSION_HANDSHAKE an (malloc, siehe handle_client)
+client_info_t* create_client_info(int client_socket, const struct sockaddr_in* client_addr) {
+    client_info_t* client = calloc(1, sizeof(client_info_t));
+    if (client == NULL) {
+        return NULL;
+    }
+    
+    client->client_socket = client_socket;
+    client->client_addr = *client_addr;
+    client->authenticated = 0;
+    client->state = SESSION_HANDSHAKE;
+    client->period_ns = TASK_PERIOD_SEC * 1000000000LL;
+    client->priority = RT_PRIORITY;
+    sem_init(&client->rt_exited, 0, 0);
+    
+    // Client-IP extrahieren
+    inet_ntop(AF_INET, &(client_addr->sin_addr), client->client_ip, INET_ADDRSTRLEN);
+    return client;
+}
+
+// Gibt eine nicht mehr registrierte Sitzung frei (TLS-Zustand, Socket, Speicher)
+void free_client_info(client_info_t* client) {
+    if (client->ssl != NULL) {
+        SSL_free(client->ssl);
+    }
+    close(client->client_socket);
+    sem_destroy(&client->rt_exited);
+    free(client);
+}
+
+// ========================================
+// HANDSHAKE-REAKTOR
+// ========================================
+// Ein einzelner Thread führt alle Anmeldungen nicht-blockierend per poll()
+// durch: Prompt, Benutzername (auch über mehrere Segmente verteilt),
+// Admission Control und Uhrenabgleich. Erst eine fertig angemeldete Sitzung
+// bekommt einen Handler- und RT-Thread - ein Client, der verbindet und
+// schweigt, belegt damit nur einen Tabelleneintrag statt eines Threads mit
+// gelocktem Stack. Die Acceptoren übergeben neue Clients über eine Pipe.
+typedef enum {
+    HS_TLS,          // TLS-Handshake (nur mit -C, gleiche Frist wie der Benutzername)
+    HS_USERNAME,     // Warten auf die Anmeldezeile (Frist: username_timeout_ms)
+    HS_CLOCK_SYNC    // Angemeldet, Uhrenabgleich bis zum Start (Frist: start_timeout_ms)
+} handshake_phase_t;
+
+typedef enum {
+    HS_CONTINUE,
+    HS_READY,             // Anmeldung abgeschlossen, RT-Thread starten
+    HS_TIMEOUT_USERNAME,  // Keine Anmeldezeile innerhalb der Frist
+    HS_TIMEOUT_START,     // Uhrenabgleich nicht innerhalb der Frist beendet
+    HS_EVICTED,           // Älteste nicht angemeldete Verbindung für eine neue verdrängt
+    HS_AUTH_FAILED,       // Benutzer unbekannt oder Admission abgelehnt
+    HS_TLS_FAILED,        // TLS-Handshake fehlgeschlagen
+    HS_PROTOCOL,          // Verbindung beendet oder Zeile zu lang
+    HS_HANDOVER           // Anmeldung fertig, aber Handover läuft: Client meldet sich beim Nachfolger an
+} handshake_result_t;
+
+typedef struct {
+    client_info_t* client;
+    handshake_phase_t phase;
+    char buffer[BUFFER_SIZE];
+    size_t used;
+    struct timespec accepted_at;    // Für die Verdrängung (älteste zuerst)
+    struct timespec deadline;       // Frist der aktuellen Phase
+    struct timespec last_activity;  // Stille-Fenster des Uhrenabgleichs
+    int sync_answered;
+    int want_write;                 // TLS-Handshake wartet auf POLLOUT
+} handshake_t;
+
+// Verworfene Anmeldungen je Regel (nur der Reaktor schreibt)
+typedef struct {
+    unsigned long completed;
+    unsigned long timeout_username;
+    unsigned long timeout_start;
+    unsigned long evicted;
+    unsigned long refused_full;     // Tabelle voll, nur angemeldete Einträge: neue Verbindung abgewiesen
+    unsigned long auth_failed;
+    unsigned long tls_failed;
+    unsigned long protocol;
+    unsigned long registry_full;
+    unsigned long handover;
+} handshake_stats_t;
+
+handshake_stats_t handshake_stats;
+volatile int handshake_pending = 0;   // Laufende Anmeldungen (für STATS)
+int handshake_pipe[2] = { -1, -1 };   // Acceptoren -> Reaktor (client_info_t*)
+
+void format_handshake_stats(char* line, size_t size, int pending) {
+    snprintf(line, size,
+             "handshakes pending=%d completed=%lu timeout_username=%lu timeout_start=%lu evicted=%lu refused_full=%lu auth_failed=%lu tls_failed=%lu protocol=%lu registry_full=%lu handover=%lu\n",
+             pending, handshake_stats.completed, handshake_stats.timeout_username,
+             handshake_stats.timeout_start, handshake_stats.evicted, handshake_stats.refused_full,
+             handshake_stats.auth_failed, handshake_stats.tls_failed, handshake_stats.protocol,
+             handshake_stats.registry_full, handshake_stats.handover);
+}
+
+void timespec_add_ms(struct timespec* t, int ms) {
+    timespec_add_ns(t, ms * 1000000LL);
+}
+
+const char* auth_prompt = "=== REMOTE AUTHENTICATION ===\nUsername: ";
+
+// Übernimmt einen neuen Client: registrieren, Socket nicht-blockierend, Prompt
+// senden (mit TLS erst nach dem TLS-Handshake)
+int handshake_start(handshake_t* hs, client_info_t* client, const struct timespec* now) {
+    if (!register_session(client)) {
+        const char* full_msg = "✗ Server full. Try again later.\n";
+        send(client->client_socket, full_msg, strlen(full_msg), MSG_DONTWAIT | MSG_NOSIGNAL);
+        printf("Sitzungsregister voll, %s abgewiesen\n", client->client_ip);
+        handshake_stats.registry_full++;
+        close(client->client_socket);
+        free(client);
+        return 0;
+    }
+    
+    printf("\n=== NEUER CLIENT ===\n");
+    printf("Client verbunden von IP: %s\n", client->client_ip);
+    
+    memset(hs, 0, sizeof(*hs));
+    hs->client = client;
+    hs->phase = HS_USERNAME;
+    hs->accepted_at = *now;
+    hs->deadline = *now;
+    timespec_add_ms(&hs->deadline, server_config.username_timeout_ms);
+    
+    fcntl(client->client_socket, F_SETFL, fcntl(client->client_socket, F_GETFL) | O_NONBLOCK);
+    if (tls_ctx != NULL) {
+        client->ssl = SSL_new(tls_ctx);
+        if (client->ssl != NULL && SSL_set_fd(client->ssl, client->client_socket) == 1) {
+            SSL_set_accept_state(client->ssl);
+            hs->phase = HS_TLS;
+            return 1;
+        }
+        printf("✗ SSL_new für %s fehlgeschlagen\n", client->client_ip);
+        pthread_mutex_lock(&session_mutex);
+        unregister_session_locked(client);
+        pthread_mutex_unlock(&session_mutex);
+        handshake_stats.tls_failed++;
+        free_client_info(client);
+        return 0;
+    }
+    
+    // Frischer Socket: Der Prompt passt immer in den leeren Sendepuffer
+    session_send(client, auth_prompt, strlen(auth_prompt));
+    return 1;
+}
+
+// Liest verfügbare Daten und arbeitet alle vollständigen Zeilen ab. Gelesen
+// wird bis EAGAIN, weil OpenSSL entschlüsselte Daten puffern kann, ohne dass
+// der Socket erneut lesbar wird.
+handshake_result_t handshake_read(handshake_t* hs, const struct timespec* now) {
+    client_info_t* client = hs->client;
+    
+    if (hs->phase == HS_TLS) {
+        int done = tls_accept_step(client, &hs->want_write);
+        if (done < 0) {
+            return HS_TLS_FAILED;
+        }
+        if (done == 0) {
+            return HS_CONTINUE;
+        }
+        hs->phase = HS_USERNAME;
+        session_send(client, auth_prompt, strlen(auth_prompt));
+    }
+    
+    for (;;) {
+        char* newline = memchr(hs->buffer, '\n', hs->used);
+        if (newline == NULL) {
+            // Volle Zeile ohne Newline: kein gültiger Handshake
+            if (hs->used == sizeof(hs->buffer) - 1) {
+                return HS_PROTOCOL;
+            }
+            ssize_t n = session_recv(client, hs->buffer + hs->used,
+                                     sizeof(hs->buffer) - 1 - hs->used);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                return HS_PROTOCOL;
+            }
+            if (n < 0) {
+                return HS_CONTINUE;
+            }
+            hs->used += n;
+            hs->last_activity = *now;
+            continue;
+        }
+        *newline = '\0';
+        
+        if (hs->phase == HS_USERNAME) {
+            if (!authenticate_network_client(client, hs->buffer)) {
+                return HS_AUTH_FAILED;
+            }
+            client->authenticated = 1;
+            hs->phase = HS_CLOCK_SYNC;
+            hs->deadline = *now;
+            timespec_add_ms(&hs->deadline, server_config.start_timeout_ms);
+        } else {
+            int sync = answer_clock_sync(client, hs->buffer);
+            if (sync < 0) {
+                return HS_READY;
+            }
+            hs->sync_answered += sync;
+            if (hs->sync_answered >= MAX_CLOCK_SYNC_SAMPLES) {
+                return HS_READY;
+            }
+        }
+        
+        size_t consumed = newline + 1 - hs->buffer;
+        memmove(hs->buffer, newline + 1, hs->used - consumed);
+        hs->used -= consumed;
+    }
+}
+
+handshake_result_t handshake_check_deadline(const handshake_t* hs, const struct timespec* now) {
+    if (timespec_diff_ms(now, &hs->deadline) >= 0.0) {
+        return hs->phase == HS_CLOCK_SYNC ? HS_TIMEOUT_START : HS_TIMEOUT_USERNAME;
+    }
+    // Client ohne "SYNC DONE": Stille beendet den Uhrenabgleich wie bisher
+    if (hs->phase == HS_CLOCK_SYNC &&
+        timespec_diff_ms(now, &hs->last_activity) >= CLOCK_SYNC_WINDOW_MS) {
+        return HS_READY;
+    }
+    return HS_CONTINUE;
+}
+
+// Nächster Zeitpunkt, zu dem eine Frist oder ein Stille-Fenster abläuft (ms ab now)
+int handshake_next_timeout(const handshake_t* pending, int count, const struct timespec* now) {
+    double timeout = ACCEPT_POLL_MS;
+    
+    for (int i = 0; i < count; i++) {
+        double remaining = -timespec_diff_ms(now, &pending[i].deadline);
+        if (pending[i].phase == HS_CLOCK_SYNC) {
+            double idle = CLOCK_SYNC_WINDOW_MS - timespec_diff_ms(now, &pending[i].last_activity);
+            if (idle < remaining) remaining = idle;
+        }
+        if (remaining < timeout) timeout = remaining;
+    }
+    return timeout < 0.0 ? 0 : (int)timeout + 1;
+}
+
+// Beendet eine Anmeldung: fertige Sitzungen an einen Handler-Thread, sonst trennen.
+// Läuft ein Handover, startet keine Sitzung mehr: Der Handover-Thread hat die
+// Parkliste evtl. schon eingesammelt, die Sitzung ginge mit dem Vorgänger verloren.
+void handshake_finish(handshake_t* hs, handshake_result_t result) {
+    client_info_t* client = hs->client;
+    const char* reason = NULL;
+    
+    if (result == HS_READY) {
+        pthread_mutex_lock(&session_mutex);
+        if (handover_requested) {
+            result = HS_HANDOVER;
+        } else {
+            client->state = SESSION_STARTING;   // Ab jetzt kein Handshake mehr (Handover trennt nicht)
+        }
+        pthread_mutex_unlock(&session_mutex);
+    }
+    
+    if (result == HS_READY) {
+        pthread_t client_thread;
+        
+        if (hs->sync_answered > 0) {
+            printf("Uhrenabgleich: %d SYNC-Pings beantwortet\n", hs->sync_answered);
+        }
+        // RT-Pfad sendet blockierend
+        fcntl(client->client_socket, F_SETFL, fcntl(client->client_socket, F_GETFL) & ~O_NONBLOCK);
+        if (pthread_create(&client_thread, NULL, handle_client, client) == 0) {
+            pthread_detach(client_thread);   // Automatische Ressourcen-Freigabe
+            handshake_stats.completed++;
+            return;
+        }
+        perror("pthread_create client_thread");
+        result = HS_PROTOCOL;
+    }
+    
+    switch (result) {
+    case HS_TIMEOUT_USERNAME:
+        handshake_stats.timeout_username++;
+        reason = "✗ Handshake timeout. Connection closed.\n";
+        break;
+    case HS_TIMEOUT_START:
+        handshake_stats.timeout_start++;
+        reason = "✗ Handshake timeout. Connection closed.\n";
+        break;
+    case HS_EVICTED:
+        handshake_stats.evicted++;
+        reason = "✗ Server busy. Connection evicted.\n";
+        break;
+    case HS_AUTH_FAILED:
+        handshake_stats.auth_failed++;   // Antwort hat authenticate_network_client() gesendet
+        break;
+    case HS_TLS_FAILED:
+        handshake_stats.tls_failed++;
+        break;
+    case HS_HANDOVER:
+        handshake_stats.handover++;
+        reason = "✗ Server restarting. Please reconnect.\n";
+        break;
+    default:
+        handshake_stats.protocol++;
+        break;
+    }
+    if (reason != NULL && (client->ssl == NULL || SSL_is_init_finished(client->ssl))) {
+        session_send(client, reason, strlen(reason));   // Nicht-blockierend, kann entfallen
+    }
+    printf("Anmeldung von %s abgebrochen (%s)\n", client->client_ip,
+           result == HS_TIMEOUT_USERNAME ? "Frist Benutzername" :
+           result == HS_TIMEOUT_START ? "Frist Start" :
+           result == HS_EVICTED ? "verdrängt" :
+           result == HS_AUTH_FAILED ? "Authentifizierung" :
+           result == HS_TLS_FAILED ? "TLS" :
+           result == HS_HANDOVER ? "Handover" : "Protokoll");
+    
+    pthread_mutex_lock(&session_mutex);
+    unregister_session_locked(client);
+    pthread_mutex_unlock(&session_mutex);
+    free_client_info(client);
+}
+
+void* handshake_loop(void* arg) {
+    (void)arg;
+    int capacity = server_config.max_handshakes;
+    handshake_t* pending = calloc(capacity, sizeof(handshake_t));
+    struct pollfd* pfds = calloc(capacity + 1, sizeof(struct pollfd));
+    int pending_count = 0;
+    struct timespec now;
+    client_info_t* client;
+    
+    if (pending == NULL || pfds == NULL) {
+        perror("calloc handshake");
+        free(pending);
+        free(pfds);
+        return NULL;
+    }
+    
+    while (server_running) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        pfds[0].fd = handshake_pipe[0];
+        pfds[0].events = POLLIN;
+        for (int i = 0; i < pending_count; i++) {
+            pfds[i + 1].fd = pending[i].client->client_socket;
+            pfds[i + 1].events = pending[i].want_write ? POLLOUT : POLLIN;
+            pfds[i + 1].revents = 0;
+        }
+        
+        if (poll(pfds, pending_count + 1, handshake_next_timeout(pending, pending_count, &now)) < 0 &&
+            errno != EINTR) {
+            perror("poll handshake");
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        
+        // 1. Laufende Anmeldungen: Daten lesen, Fristen prüfen. Rückwärts, damit
+        //    das Nachrücken des letzten Eintrags keinen Eintrag überspringt.
+        for (int i = pending_count - 1; i >= 0; i--) {
+            handshake_result_t result = HS_CONTINUE;
+            if (pfds[i + 1].revents != 0) {
+                result = handshake_read(&pending[i], &now);
+            }
+            if (result == HS_CONTINUE) {
+                result = handshake_check_deadline(&pending[i], &now);
+            }
+            if (result != HS_CONTINUE) {
+                handshake_finish(&pending[i], result);
+                pending[i] = pending[--pending_count];
+            }
+        }
+        
+        // 2. Neue Clients der Acceptoren übernehmen; bei voller Tabelle die
+        //    älteste noch nicht angemeldete Verbindung (TLS/Benutzername)
+        //    verdrängen. Angemeldete Sitzungen im Uhrenabgleich haben Benutzer
+        //    und Admission bereits bestanden und bleiben; sind alle Einträge
+        //    angemeldet, wird die neue Verbindung abgewiesen.
+        if (pfds[0].revents & POLLIN) {
+            while (read(handshake_pipe[0], &client, sizeof(client)) == sizeof(client)) {
+                if (pending_count == capacity) {
+                    int oldest = -1;
+                    for (int i = 0; i < pending_count; i++) {
+                        if (pending[i].phase == HS_CLOCK_SYNC) {
+                            continue;
+                        }
+                        if (oldest < 0 ||
+                            timespec_diff_ms(&pending[i].accepted_at, &pending[oldest].accepted_at) < 0.0) {
+                            oldest = i;
+                        }
+                    }
+                    if (oldest < 0) {
+                        const char* busy = "✗ Server busy. Connection refused.\n";
+                        if (tls_ctx == NULL) {
+                            send(client->client_socket, busy, strlen(busy), MSG_DONTWAIT | MSG_NOSIGNAL);
+                        }
+                        printf("Anmeldung von %s abgewiesen (nur angemeldete Sitzungen in der Tabelle)\n",
+                               client->client_ip);
+                        handshake_stats.refused_full++;
+                        free_client_info(client);
+                        continue;
+                    }
+                    handshake_finish(&pending[oldest], HS_EVICTED);
+                    pending[oldest] = pending[--pending_count];
+                }
+                if (handshake_start(&pending[pending_count], client, &now)) {
+                    pending_count++;
+                }
+            }
+        }
+        handshake_pending = pending_count;
+    }
+    
+    // Shutdown: offene Anmeldungen und noch nicht übernommene Clients trennen
+    for (int i = 0; i < pending_count; i++) {
+        pthread_mutex_lock(&session_mutex);
+        unregister_session_locked(pending[i].client);
+        pthread_mutex_unlock(&session_mutex);
+        free_client_info(pending[i].client);
+    }
+    while (read(handshake_pipe[0], &client, sizeof(client)) == sizeof(client)) {
+        free_client_info(client);
+    }
+    handshake_pending = 0;
+    free(pending);
+    free(pfds);
+    return NULL;
+}
+
+// ========================================
+// NICHT-RT-LESER: METRIKEN UND STATS-KOMMANDO
+// ========================================
+// Der Register-Mutex sichert nur die Lebensdauer der client_info_t während
+// des Kopierens; der RT-Zustand selbst wird lockfrei per Seqlock gelesen.
+typedef struct {
+    char client_ip[INET_ADDRSTRLEN];
+    session_state_t session_state;
+    int consistent;              // 0 = Seqlock-Lesen nach SEQLOCK_READ_RETRIES aufgegeben
+    rt_state_t rt;
+} session_snapshot_t;
+
+int snapshot_sessions(session_snapshot_t* out, int max) {
+    int count = 0;
+    
+    pthread_mutex_lock(&session_mutex);
+    for (int i = 0; i < session_count && count < max; i++) {
+        session_snapshot_t* snap = &out[count++];
+        memcpy(snap->client_ip, sessions[i]->client_ip, sizeof(snap->client_ip));
+        snap->session_state = sessions[i]->state;
+        snap->consistent = rt_state_read(&sessions[i]->published, &snap->rt);
+    }
+    pthread_mutex_unlock(&session_mutex);
+    return count;
+}
+
+// Namen für STATS und -m; fehlt ein Zustand, liefert session_state_name() "unknown"
+static const char* const session_state_names[SESSION_STATE_COUNT] = {
+    [SESSION_HANDSHAKE] = "handshake",
+    [SESSION_STARTING]  = "starting",
+    [SESSION_RUNNING]   = "running",
+    [SESSION_PARKED]    = "parked",
+    [SESSION_CLOSING]   = "closing",
+};
+
+const char* session_state_name(session_state_t state) {
+    if ((unsigned)state >= SESSION_STATE_COUNT || session_state_names[state] == NULL) {
+        return "unknown";
+    }
+    return session_state_names[state];
+}
+
+void format_session_line(char* line, size_t size, const session_snapshot_t* snap) {
+    const char* state = session_state_name(snap->session_state);
+    
+    if (!snap->consistent) {
+        snprintf(line, size, "%s state=%s snapshot=busy\n", snap->client_ip, state);
+        return;
+    }
+    snprintf(line, size,
+             "%s state=%s active=%d cycles=%d last_ns=%lld next_ns=%lld lateness_us=%.1f max_lateness_us=%.1f send_errors=%lu cpu_avg_us=%.1f cpu_max_us=%.1f\n",
+             snap->client_ip, state, snap->rt.active,
+             snap->rt.cycle_count, snap->rt.last_cycle_ns, snap->rt.next_deadline_ns,
+             snap->rt.last_lateness_ns / 1000.0, snap->rt.max_lateness_ns / 1000.0,
+             snap->rt.send_errors, snap->rt.cycle_cpu_avg_ns / 1000.0,
+             snap->rt.cycle_cpu_max_ns / 1000.0);
+}
+
+// Periodische Metrik-Ausgabe (-m N), läuft als normaler Thread
+void* metrics_loop(void* arg) {
+    (void)arg;
+    session_snapshot_t* snaps = malloc(sizeof(session_snapshot_t) * MAX_SESSIONS);
+    char line[BUFFER_SIZE];
+    
+    if (snaps == NULL) {
+        perror("malloc metrics");
+        return NULL;
+    }
+    
+    while (server_running) {
+        for (int waited = 0; waited < server_config.metrics_interval * 10 && server_running; waited++) {
+            poll(NULL, 0, 100);
+        }
+        if (!server_running) break;
+        
+        int count = snapshot_sessions(snaps, MAX_SESSIONS);
+        printf("=== METRIKEN: %d Sitzungen ===\n", count);
+        for (int i = 0; i < count; i++) {
+            format_session_line(line, sizeof(line), &snaps[i]);
+            printf("  %s", line);
+        }
+    }
+    
+    free(snaps);
+    return NULL;
+}
+
+// Beantwortet das Admin-Kommando "STATS" auf dem Unix-Socket
+void send_session_stats(int peer) {
+    session_snapshot_t* snaps = malloc(sizeof(session_snapshot_t) * MAX_SESSIONS);
+    char line[BUFFER_SIZE];
+    
+    if (snaps == NULL) {
+        perror("malloc stats");
+        return;
+    }
+    
+    int count = snapshot_sessions(snaps, MAX_SESSIONS);
+    snprintf(line, sizeof(line), "sessions=%d\n", count);
+    send(peer, line, strlen(line), MSG_NOSIGNAL);
+    for (int i = 0; i < count; i++) {
+        format_session_line(line, sizeof(line), &snaps[i]);
+        send(peer, line, strlen(line), MSG_NOSIGNAL);
+    }
+    format_handshake_stats(line, sizeof(line), handshake_pending);
+    send(peer, line, strlen(line), MSG_NOSIGNAL);
+    free(snaps);
+}
+
+// ========================================
+// ACCEPTOR-THREAD
+// ========================================
+// Nimmt Verbindungen auf dem eigenen SO_REUSEPORT-Listener an. Allowlist und
+// Rate-Limit werden geprüft, bevor Speicher oder ein Handler-Thread belegt
+// werden - abgewiesene Peers kosten nur accept(), ein send() und close().
+// Während eines Handovers nimmt der Acceptor nichts mehr an; wartende
+// Verbindungen bleiben in der Listen-Queue und gehen an den Nachfolger.
+void* accept_loop(void* arg) {
+    acceptor_t* acceptor = (acceptor_t*)arg;
+    struct sockaddr_in client_addr;
+    socklen_t client_addr_len;
+    int client_socket;
+    struct pollfd pfd = { .fd = acceptor->listen_socket, .events = POLLIN };
+    
+    while (server_running) {
+        if (handover_requested) {
+            acceptor->idle = 1;
+            poll(NULL, 0, ACCEPT_POLL_MS);
+            continue;
+        }
+        
+        if (poll(&pfd, 1, ACCEPT_POLL_MS) <= 0) {
+            continue;
+        }
+        
+        client_addr_len = sizeof(client_addr);
+        client_socket = accept(acceptor->listen_socket, (struct sockaddr*)&client_addr, &client_addr_len);
+        
+        if (client_socket < 0) {
+            if (server_running && errno != EINTR && errno != ECONNABORTED &&
+                errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("accept");
+            }
+            continue;
+        }
+        
+        // 1. Allowlist (Integer-Vergleich, keine String-Konvertierung)
+        int peer_index = find_allowed_peer(client_addr.sin_addr);
+        if (peer_index < 0) {
+            const char* ip_error = "✗ IP address not authorized. Connection refused.\n";
+            send(client_socket, ip_error, strlen(ip_error), MSG_DONTWAIT | MSG_NOSIGNAL);
+            close(client_socket);
+            acceptor->rejected_ip++;
+            continue;
+        }
+        
+        // 2. Verbindungs-Rate-Limit pro IP
+        if (!rate_limit_allow(peer_index)) {
+            const char* rate_error = "✗ Connection rate limit exceeded. Try again later.\n";
+            send(client_socket, rate_error, strlen(rate_error), MSG_DONTWAIT | MSG_NOSIGNAL);
+            close(client_socket);
+            acceptor->rejected_rate++;
+            continue;
+        }
+        
+        // Client-Info erstellen
+        client_info_t* client = create_client_info(client_socket, &client_addr);
+        if (client == NULL) {
+            perror("calloc");
+            close(client_socket);
+            continue;
+        }
+        
+        printf("✓ IP-Adresse %s ist autorisiert (%s, Acceptor %d)\n",
+               client->client_ip, allowed_peers[peer_index].label, acceptor->index);
+        
+        // An den Handshake-Reaktor übergeben (Zeiger-Schreiben <= PIPE_BUF ist atomar)
+        if (write(handshake_pipe[1], &client, sizeof(client)) != sizeof(client)) {
+            const char* busy_error = "✗ Server busy. Try again later.\n";
+            send(client_socket, busy_error, strlen(busy_error), MSG_DONTWAIT | MSG_NOSIGNAL);
+            close(client_socket);
+            free(client);
+            acceptor->rejected_queue++;
+            continue;
+        }
+        acceptor->accepted++;
+    }
+    
+    return NULL;
+}
+
+// ========================================
+// REUSEPORT-CPU-STEERING
+// ========================================
+// Klassisches BPF-Programm für die SO_REUSEPORT-Gruppe: Der Rückgabewert ist
+// der Index des Listeners (in Bind-Reihenfolge). "CPU mod N" lenkt jede
+// Verbindung auf den Acceptor, der zur Empfangs-CPU bzw. RX-Queue passt.
+int attach_cpu_steering(int listen_socket, int count) {
+    struct sock_filter code[] = {
+        { BPF_LD  | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },  // A = aktuelle CPU
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (unsigned int)count },      // A = A % count
+        { BPF_RET | BPF_A, 0, 0, 0 },                                  // return A
+    };
+    struct sock_fprog prog = {
+        .len = sizeof(code) / sizeof(code[0]),
+        .filter = code,
+    };
+    
+    if (setsockopt(listen_socket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        perror("setsockopt SO_ATTACH_REUSEPORT_CBPF");
+        return 0;
+    }
+    return 1;
+}
+
+// ========================================
+// LISTENER-SOCKET ERSTELLEN
+// ========================================
+// Erstellt einen Listener in der SO_REUSEPORT-Gruppe von SERVER_PORT
+int create_listener(void) {
+    struct sockaddr_in server_addr;
+    int opt = 1;
+    int listen_socket;
+    
+    listen_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_socket < 0) {
+        perror("socket");
+        return -1;
+    }
+    
+    // Socket-Optionen setzen (Adresse wiederverwenden, Port mit anderen Acceptoren teilen)
+    if (setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        setsockopt(listen_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt");
+        close(listen_socket);
+        return -1;
+    }
+    
+    // Server-Adresse konfigurieren
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET; // IPv4   
+    server_addr.sin_addr.s_addr = INADDR_ANY;  // Alle verfügbaren Interfaces
+    server_addr.sin_port = htons(SERVER_PORT); // Port in Netzwerk-Byte-Reihenfolge
+    
+    // Socket an Port binden
+    if (bind(listen_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("bind");
+        close(listen_socket);
+        return -1;
+    }
+    
+    // Auf Verbindungen lauschen
+    if (listen(listen_socket, server_config.listen_backlog) < 0) {
+        perror("listen");
+        close(listen_socket);
+        return -1;
+    }
+    
+    // Nicht-blockierend: accept() nach poll() darf nie hängen bleiben, falls
+    // ein anderer Acceptor oder der Nachfolger die Verbindung zuerst nimmt
+    fcntl(listen_socket, F_SETFL, fcntl(listen_socket, F_GETFL) | O_NONBLOCK);
+    
+    return listen_socket;
+}
+
+// ========================================
+// HANDOVER: DATENFORMAT
+// ========================================
+// Übertragung über den Unix-Socket: zuerst der Header mit allen Listener-FDs
+// als SCM_RIGHTS, danach je Sitzung ein Datensatz mit dem Client-FD.
+// Beide Prozesse laufen auf demselben Host, CLOCK_MONOTONIC ist daher
+// identisch und next_period kann unverändert übernommen werden.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t listener_count;
+    int32_t session_count;
+    struct timespec freeze_time;    // Beginn des Handovers im Vorgänger
+} handover_header_t;
+
+typedef struct {
+    char client_ip[INET_ADDRSTRLEN];
+    struct sockaddr_in client_addr;
+    int32_t started;
+    int32_t cycle_count;
+    int32_t priority;
+    int32_t ktls_tx;                // TLS-Zustand liegt im Socket, Nachfolger sendet per send()
+    int64_t period_ns;
+    double reserved_util;
+    char username[MAX_USERNAME_LENGTH];
+    struct timespec next_period;
+} handover_session_t;
+
+// Sendet einen Datenblock zusammen mit Dateideskriptoren (SCM_RIGHTS)
+int send_with_fds(int sock, const void* data, size_t len, const int* fds, int fd_count) {
+    char control[CMSG_SPACE(sizeof(int) * MAX_ACCEPTORS)];
+    struct iovec iov = { .iov_base = (void*)data, .iov_len = len };
+    struct msghdr msg;
+    
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    
+    if (fd_count > 0) {
+        memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * fd_count);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fd_count);
+    }
+    
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == (ssize_t)len;
+}
+
+// Empfängt einen Datenblock fester Länge und bis zu max_fds Dateideskriptoren
+int recv_with_fds(int sock, void* data, size_t len, int* fds, int max_fds, int* fd_count) {
+    char control[CMSG_SPACE(sizeof(int) * MAX_ACCEPTORS)];
+    struct iovec iov = { .iov_base = data, .iov_len = len };
+    struct msghdr msg;
+    
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    *fd_count = 0;
+    
+    if (recvmsg(sock, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC) != (ssize_t)len) {
+        return 0;
+    }
+    
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            int* received = (int*)CMSG_DATA(cmsg);
+            for (int i = 0; i < n; i++) {
+                if (*fd_count < max_fds) {
+                    fds[(*fd_count)++] = received[i];
+                } else {
+                    close(received[i]);
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+// ========================================
+// HANDOVER: VORGÄNGER-SEITE
+// ========================================
+// Friert alle Sitzungen an ihrer nächsten Zyklusgrenze ein und übergibt
+// Listener, Client-Sockets und Zyklus-Zustand an den verbundenen Nachfolger.
+// Sitzungen in der Authentifizierung werden sofort getrennt (der Client
+// meldet sich beim Nachfolger neu an); gewartet wird nur auf RT-Sitzungen,
+// höchstens HANDOVER_TIMEOUT_MS.
+// Startet eine eingefrorene Sitzung (Nachfolger oder gescheiterter Handover)
+// mit einem neuen Handler; der RT-Thread läuft auf ihrem Raster weiter.
+// Gibt 0 zurück, wenn die Sitzung verworfen werden musste.
+int start_resumed_session(client_info_t* client, const struct timespec* freeze_time) {
+    pthread_t client_thread;
+    
+    client->parked = 0;
+    client->resumed = 1;
+    client->freeze_time = *freeze_time;
+    client->state = SESSION_STARTING;
+    
+    if (!register_session(client)) {
+        printf("Sitzungsregister voll, %s nicht fortgesetzt\n", client->client_ip);
+        free_client_info(client);
+        return 0;
+    }
+    if (pthread_create(&client_thread, NULL, handle_client, client) != 0) {
+        perror("pthread_create client_thread");
+        pthread_mutex_lock(&session_mutex);
+        unregister_session_locked(client);
+        pthread_mutex_unlock(&session_mutex);
+        free_client_info(client);
+        return 0;
+    }
+    pthread_detach(client_thread);
+    return 1;
+}
+
+// Gibt bei Erfolg 1 zurück. Scheitert die Übergabe, laufen alle nicht
+// übergebenen Sitzungen lokal weiter (kein Verlust durch einen defekten Nachfolger).
+int perform_handover(int peer) {
+    handover_header_t header;
+    client_info_t* parked[MAX_SESSIONS];
+    int parked_count = 0;
+    client_info_t* local_only[MAX_SESSIONS];   // Geparkt, aber nicht übertragbar
+    int local_count = 0;
+    int listener_fds[MAX_ACCEPTORS];
+    struct timespec now;
+    
+    memset(&header, 0, sizeof(header));
+    clock_gettime(CLOCK_MONOTONIC, &header.freeze_time);
+    printf("\n=== HANDOVER GESTARTET ===\n");
+    
+    // 1. Handshakes trennen, damit kein stiller Peer die RT-Sitzungen aufhält.
+    //    Unter session_mutex: Der Reaktor startet danach keine Sitzung mehr.
+    pthread_mutex_lock(&session_mutex);
+    handover_requested = 1;
+    for (int i = 0; i < session_count; i++) {
+        if (sessions[i]->state == SESSION_HANDSHAKE) {
+            shutdown(sessions[i]->client_socket, SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&session_mutex);
+    
+    // 2. Acceptoren anhalten, RT-Threads wecken und auf das Parken warten
+    for (;;) {
+        int acceptors_busy = 0;
+        int sessions_busy = 0;
+        
+        for (int i = 0; i < acceptor_count; i++) {
+            if (!acceptors[i].idle) acceptors_busy++;
         }
         
-        // Client-Info erstellen
-        client_info_t* client = malloc(sizeof(client_info_t));
-        if (client == NULL) {
-            perror("malloc");
-            close(client_socket);
+        pthread_mutex_lock(&session_mutex);
+        for (int i = 0; i < session_count; i++) {
+            if (sessions[i]->state == SESSION_RUNNING) {
+                pthread_kill(sessions[i]->thread_id, SIGUSR1);
+            }
+            if (sessions[i]->state == SESSION_RUNNING || sessions[i]->state == SESSION_STARTING) {
+                sessions_busy++;
+            }
+        }
+        pthread_mutex_unlock(&session_mutex);
+        
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((acceptors_busy == 0 && sessions_busy == 0) ||
+            timespec_diff_ms(&now, &header.freeze_time) > HANDOVER_TIMEOUT_MS) {
+            break;
+        }
+        poll(NULL, 0, 10);
+    }
+    
+    // 3. Geparkte Sitzungen aus dem Register nehmen, übrige Handshakes trennen
+    //    (von Acceptoren seit Schritt 1 noch übergebene).
+    //    TLS-Sitzungen ohne kTLS sind nicht übertragbar: Ihr Record-Zustand
+    //    liegt in OpenSSL, nicht im Socket. Sie werden erst nach erfolgreicher
+    //    Übergabe getrennt.
+    pthread_mutex_lock(&session_mutex);
+    for (int i = 0; i < session_count; ) {
+        if (sessions[i]->state == SESSION_PARKED && sessions[i]->ssl != NULL &&
+            !sessions[i]->ktls_tx) {
+            local_only[local_count++] = sessions[i];
+            sessions[i] = sessions[--session_count];
+        } else if (sessions[i]->state == SESSION_PARKED) {
+            parked[parked_count++] = sessions[i];
+            sessions[i] = sessions[--session_count];
+        } else {
+            if (sessions[i]->state == SESSION_HANDSHAKE) {
+                shutdown(sessions[i]->client_socket, SHUT_RDWR);
+            }
+            i++;
+        }
+    }
+    pthread_mutex_unlock(&session_mutex);
+    
+    // 4. Header mit Listenern senden
+    header.magic = HANDOVER_MAGIC;
+    header.version = HANDOVER_VERSION;
+    header.listener_count = acceptor_count;
+    header.session_count = parked_count;
+    for (int i = 0; i < acceptor_count; i++) {
+        listener_fds[i] = acceptors[i].listen_socket;
+    }
+    
+    int ok = send_with_fds(peer, &header, sizeof(header), listener_fds, acceptor_count);
+    
+    // 5. Sitzungen einzeln mit ihrem Client-Socket senden; nach dem ersten
+    //    Fehler bleiben die restlichen Sitzungen hier
+    int sent_count = 0;
+    for (int i = 0; i < parked_count && ok; i++) {
+        client_info_t* client = parked[i];
+        handover_session_t record;
+        
+        memset(&record, 0, sizeof(record));
+        memcpy(record.client_ip, client->client_ip, sizeof(record.client_ip));
+        record.client_addr = client->client_addr;
+        record.started = client->started;
+        record.cycle_count = client->cycle_count;
+        record.priority = client->priority;
+        record.ktls_tx = client->ktls_tx;
+        record.period_ns = client->period_ns;
+        record.reserved_util = client->reserved_util;
+        if (client->user != NULL) {
+            memcpy(record.username, client->user->name, sizeof(record.username));
+        }
+        record.next_period = client->next_period;
+        ok = send_with_fds(peer, &record, sizeof(record), &client->client_socket, 1);
+        
+        // Der Nachfolger hält jetzt eigene Referenzen auf den Socket
+        if (ok) {
+            free_client_info(client);
+            sent_count++;
+        }
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (ok) {
+        for (int i = 0; i < local_count; i++) {
+            printf("TLS-Sitzung %s ohne kTLS nicht übertragbar, getrennt\n", local_only[i]->client_ip);
+            free_client_info(local_only[i]);
+        }
+        printf("Handover abgeschlossen: %d Listener, %d Sitzungen in %.3f ms übergeben\n",
+               acceptor_count, parked_count, timespec_diff_ms(&now, &header.freeze_time));
+        return 1;
+    }
+    
+    // 6. Fehlgeschlagen: nicht übergebene Sitzungen lokal auf ihrem Raster fortsetzen
+    perror("Handover senden");
+    int restarted = 0;
+    handover_requested = 0;   // Sonst parkt handle_client() die Sitzung sofort wieder
+    for (int i = sent_count; i < parked_count; i++) {
+        restarted += start_resumed_session(parked[i], &header.freeze_time);
+    }
+    for (int i = 0; i < local_count; i++) {
+        restarted += start_resumed_session(local_only[i], &header.freeze_time);
+    }
+    printf("Handover fehlgeschlagen: %d Sitzungen übergeben, %d lokal fortgesetzt\n",
+           sent_count, restarted);
+    return 0;
+}
+
+// Liest die Kommandozeile eines Unix-Socket-Peers ("HANDOVER" oder "STATS")
+int read_admin_command(int peer, char* command, size_t size) {
+    struct pollfd pfd = { .fd = peer, .events = POLLIN };
+    size_t used = 0;
+    
+    while (used < size - 1) {
+        if (poll(&pfd, 1, 1000) <= 0) {
+            return 0;
+        }
+        ssize_t n = recv(peer, command + used, 1, 0);
+        if (n <= 0) {
+            return 0;
+        }
+        if (command[used] == '\n') {
+            break;
+        }
+        used++;
+    }
+    command[used] = '\0';
+    if (used > 0 && command[used - 1] == '\r') {
+        command[used - 1] = '\0';
+    }
+    return 1;
+}
+
+// Admin-Socket: Nimmt "STATS" (Snapshot aller Sitzungen) und "HANDOVER"
+// (Übergabe an einen Nachfolger) entgegen
+void* handover_listener_loop(void* arg) {
+    (void)arg;
+    
+    while (server_running) {
+        int peer = accept(handover_socket, NULL, NULL);
+        if (peer < 0) {
+            if (errno == EINTR) continue;
+            break;   // shutdown() beim Beenden
+        }
+        
+        // Nur Prozesse desselben Benutzers dürfen Zustand lesen oder Sockets übernehmen
+        struct ucred cred;
+        socklen_t cred_len = sizeof(cred);
+        if (getsockopt(peer, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 ||
+            cred.uid != getuid()) {
+            printf("✗ Admin-Anfrage von fremdem Benutzer abgelehnt\n");
+            close(peer);
             continue;
         }
         
-        client->client_socket = client_socket;
-        client->client_addr = client_addr;
-        client->authenticated = 0;
+        char command[32];
+        if (!read_admin_command(peer, command, sizeof(command))) {
+            close(peer);
+            continue;
+        }
+        if (strcmp(command, "STATS") == 0) {
+            send_session_stats(peer);
+            close(peer);
+            continue;
+        }
+        if (strcmp(command, "HANDOVER") != 0) {
+            const char* unknown = "unknown command (STATS, HANDOVER)\n";
+            send(peer, unknown, strlen(unknown), MSG_NOSIGNAL);
+            close(peer);
+            continue;
+        }
         
-        // Client-IP extrahieren
-        inet_ntop(AF_INET, &(client_addr.sin_addr), client->client_ip, INET_ADDRSTRLEN);
+        int ok = perform_handover(peer);
+        close(peer);
+        if (ok) {
+            handover_done = 1;
+            server_running = 0;   // Acceptoren beenden, main() räumt auf
+            break;
+        }
         
-        // Client-Handler-Thread starten
-        if (pthread_create(&client_thread, NULL, handle_client, client) != 0) {
-            perror("pthread_create client_thread");
-            free(client);
+        // Fehlgeschlagen: Sitzungen laufen lokal weiter, neue wieder annehmen
+        handover_requested = 0;
+        for (int i = 0; i < acceptor_count; i++) {
+            acceptors[i].idle = 0;
+        }
+    }
+    return NULL;
+}
+
+// Prüft vor dem Start, ob auf dem Handover-Pfad ein laufender Server antwortet.
+// Ohne -t darf ein zweiter Server dessen Admin-Socket nicht übernehmen und
+// (SO_REUSEPORT) nicht unbemerkt derselben Port-Gruppe beitreten.
+// 1 = Server aktiv, 0 = frei oder verwaiste Socket-Datei, -1 = Fehler
+int handover_owner_alive(const char* path) {
+    struct sockaddr_un addr;
+    int alive;
+    
+    int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        perror("socket AF_UNIX");
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        alive = 1;
+    } else if (errno == ECONNREFUSED || errno == ENOENT) {
+        alive = 0;
+    } else {
+        perror("connect handover");
+        alive = -1;
+    }
+    close(sock);
+    return alive;
+}
+
+// Bindet den Unix-Socket, über den ein Nachfolger den Handover anfordert
+int create_handover_socket(const char* path) {
+    struct sockaddr_un addr;
+    int sock;
+    
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Handover-Pfad zu lang: %s\n", path);
+        return -1;
+    }
+    
+    sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        perror("socket AF_UNIX");
+        return -1;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    
+    unlink(path);   // Verwaist oder vom Vorgänger (-t), siehe handover_owner_alive()
+    mode_t old_mask = umask(077);   // Socket-Datei nur für den Eigentümer
+    int ret = bind(sock, (struct sockaddr*)&addr, sizeof(addr));
+    umask(old_mask);
+    if (ret < 0 || listen(sock, 1) < 0) {
+        perror("bind/listen handover");
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// ========================================
+// HANDOVER: NACHFOLGER-SEITE
+// ========================================
+// Verbindet sich mit dem laufenden Vorgänger, übernimmt dessen Listener
+// (acceptors[]) und startet für jede übergebene Sitzung einen Handler, der
+// den RT-Thread auf dem unveränderten Zyklus-Raster fortsetzt.
+int takeover_from_predecessor(const char* path) {
+    struct sockaddr_un addr;
+    handover_header_t header;
+    int listener_fds[MAX_ACCEPTORS];
+    int fd_count;
+    int resumed = 0;
+    int sock;
+    
+    sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        perror("socket AF_UNIX");
+        return 0;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect handover");
+        close(sock);
+        return 0;
+    }
+    if (send(sock, "HANDOVER\n", 9, MSG_NOSIGNAL) != 9) {
+        perror("send handover");
+        close(sock);
+        return 0;
+    }
+    printf("Verbunden mit Vorgänger über %s, warte auf Übergabe...\n", path);
+    
+    // 1. Header und Listener
+    if (!recv_with_fds(sock, &header, sizeof(header), listener_fds, MAX_ACCEPTORS, &fd_count) ||
+        header.magic != HANDOVER_MAGIC || header.version != HANDOVER_VERSION ||
+        header.listener_count != fd_count || fd_count < 1) {
+        printf("✗ Ungültiger Handover-Header\n");
+        for (int i = 0; i < fd_count; i++) close(listener_fds[i]);
+        close(sock);
+        return 0;
+    }
+    
+    for (int i = 0; i < fd_count; i++) {
+        acceptors[i].index = i;
+        acceptors[i].listen_socket = listener_fds[i];
+        acceptors[i].accepted = 0;
+        acceptors[i].rejected_ip = 0;
+        acceptors[i].rejected_rate = 0;
+        acceptors[i].idle = 0;
+    }
+    acceptor_count = fd_count;
+    server_config.acceptor_count = fd_count;
+    
+    // 2. Sitzungen übernehmen und sofort fortsetzen
+    for (int i = 0; i < header.session_count; i++) {
+        handover_session_t record;
+        int client_socket;
+        
+        if (!recv_with_fds(sock, &record, sizeof(record), &client_socket, 1, &fd_count) || fd_count != 1) {
+            printf("✗ Handover nach %d von %d Sitzungen abgebrochen\n", i, header.session_count);
+            break;
+        }
+        
+        record.client_ip[INET_ADDRSTRLEN - 1] = '\0';
+        client_info_t* client = create_client_info(client_socket, &record.client_addr);
+        if (client == NULL) {
+            perror("calloc");
             close(client_socket);
             continue;
         }
+        client->authenticated = 1;
+        client->started = record.started;
+        client->cycle_count = record.cycle_count;
+        client->priority = record.priority;
+        client->ktls_tx = record.ktls_tx;   // ssl bleibt NULL: send() genügt
+        client->period_ns = record.period_ns;
+        record.username[MAX_USERNAME_LENGTH - 1] = '\0';
+        // Bereits zugelassen: Reservierung übernehmen, ohne erneute Admission
+        client->user = find_user(record.username);
+        client->reserved_util = record.reserved_util;
+        client->admitted = 1;
+        if (client->user == NULL) {
+            printf("Warnung: Benutzer '%s' fehlt in der Datenbank, Sitzung läuft ohne Quote weiter\n",
+                   record.username);
+        }
+        client->next_period = record.next_period;
+        resumed += start_resumed_session(client, &header.freeze_time);
+    }
+    close(sock);
+    
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    printf("✓ Handover übernommen: %d Listener, %d/%d Sitzungen, %.3f ms seit Einfrieren\n",
+           acceptor_count, resumed, header.session_count,
+           timespec_diff_ms(&now, &header.freeze_time));
+    return 1;
+}
+
+// ========================================
+// SIMULATION (VIRTUELLE UHR)
+// ========================================
+// Startet sim_sessions Sitzungen ohne Netzwerk, Authentifizierung und
+// Admission Control; jede sendet über ein socketpair() an den Drain-Thread.
+// handle_client(), client_realtime_task(), session_send() und die Seqlock-
+// Veröffentlichung laufen unverändert, nur die Uhr ist virtuell. Die Uhr hat
+// rt_cpus (-k) virtuelle CPUs; Sitzung i erhält die Priorität
+// RT_PRIORITY - (i % SIM_PRIORITY_LEVELS) * 10 und den Jitter-Seed i+1:
+// gleiche Parameter ergeben die gleiche Prüfsumme.
+#define SIM_PRIORITY_LEVELS 4
+
+typedef struct {
+    int fds[MAX_SIM_SESSIONS];
+    int count;
+} sim_drain_t;
+
+// Liest die Zyklus-Meldungen aller Sitzungen weg, damit send() nie blockiert
+void* sim_drain_loop(void* arg) {
+    sim_drain_t* drain = (sim_drain_t*)arg;
+    struct pollfd pfds[MAX_SIM_SESSIONS];
+    char buffer[4096];
+    int open_count = drain->count;
+    
+    for (int i = 0; i < drain->count; i++) {
+        pfds[i].fd = drain->fds[i];
+        pfds[i].events = POLLIN;
+    }
+    
+    while (open_count > 0) {
+        if (poll(pfds, drain->count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+        for (int i = 0; i < drain->count; i++) {
+            if (pfds[i].fd < 0 || pfds[i].revents == 0) {
+                continue;
+            }
+            if (read(pfds[i].fd, buffer, sizeof(buffer)) <= 0) {
+                close(pfds[i].fd);
+                pfds[i].fd = -1;   // Von poll() ignoriert
+                open_count--;
+            }
+        }
+    }
+    return NULL;
+}
+
+int run_simulation(void) {
+    int count = server_config.sim_sessions;
+    client_info_t* clients[MAX_SIM_SESSIONS];
+    pthread_t threads[MAX_SIM_SESSIONS];
+    int running[MAX_SIM_SESSIONS];
+    sim_drain_t drain;
+    pthread_t drain_thread;
+    struct sockaddr_in addr;
+    struct timespec wall_start, wall_end, virtual_end;
+    
+    printf("=== SECURE REALTIME SERVER: SIMULATION ===\n");
+    printf("Sitzungen: %d, Zyklen: %d, Periode: %d ms, Kosten: %lld us, Jitter: %lld us, CPUs: %d\n",
+           count, server_config.cycles, server_config.sim_period_ms,
+           server_config.sim_cost_us, server_config.sim_jitter_us, server_config.rt_cpus);
+    
+    rt_virtual_clock_init(&virtual_clock, 0, server_config.sim_jitter_us * 1000LL,
+                          server_config.rt_cpus);
+    rt_clock = &virtual_clock;
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, AUTHORIZED_IP, &addr.sin_addr);
+    
+    drain.count = count;
+    for (int i = 0; i < count; i++) {
+        int pair[2];
+        
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            perror("socketpair");
+            return EXIT_FAILURE;
+        }
+        clients[i] = create_client_info(pair[0], &addr);
+        if (clients[i] == NULL || !register_session(clients[i])) {
+            printf("Simulierte Sitzung %d nicht anlegbar\n", i);
+            return EXIT_FAILURE;
+        }
+        snprintf(clients[i]->client_ip, sizeof(clients[i]->client_ip), "sim-%d", i);
+        clients[i]->authenticated = 1;
+        clients[i]->period_ns = server_config.sim_period_ms * 1000000LL;
+        clients[i]->priority = RT_PRIORITY - (i % SIM_PRIORITY_LEVELS) * 10;
+        clients[i]->sim_index = i;
+        clients[i]->jitter_state = (uint32_t)i + 1;
+        clients[i]->lateness_digest = RT_CLOCK_DIGEST_INIT;
+        drain.fds[i] = pair[1];
         
-        // Thread detachen (automatische Ressourcen-Freigabe)
-        pthread_detach(client_thread);
+        // Alle Teilnehmer vor dem ersten Thread anmelden, sonst springt die
+        // Uhr, sobald der erste allein schläft
+        rt_clock_attach(rt_clock);
     }
     
+    if (pthread_create(&drain_thread, NULL, sim_drain_loop, &drain) != 0) {
+        perror("pthread_create drain");
+        return EXIT_FAILURE;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    for (int i = 0; i < count; i++) {
+        running[i] = pthread_create(&threads[i], NULL, handle_client, clients[i]) == 0;
+        if (!running[i]) {
+            perror("pthread_create");
+            rt_clock_detach(rt_clock);
+            pthread_mutex_lock(&session_mutex);
+            unregister_session_locked(clients[i]);
+            pthread_mutex_unlock(&session_mutex);
+            free_client_info(clients[i]);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (running[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    rt_clock_now(rt_clock, &virtual_end);
+    pthread_join(drain_thread, NULL);   // Endet, wenn alle Sitzungen geschlossen sind
+    
+    double wall_s = timespec_diff_ms(&wall_end, &wall_start) / 1000.0;
+    double virtual_s = timespec_to_ns(&virtual_end) / 1e9;
+    double utilization = virtual_clock.busy_ns / 1e9 / virtual_s / server_config.rt_cpus;
+    
+    printf("\n=== SIMULATION ABGESCHLOSSEN ===\n");
+    printf("Sitzungen: %lu, Zyklen: %lu\n", sim_stats.sessions, sim_stats.cycles);
+    printf("Virtuelle Dauer: %.3f s, Echtzeit: %.3f s (Faktor %.0f)\n",
+           virtual_s, wall_s, wall_s > 0 ? virtual_s / wall_s : 0.0);
+    printf("Durchsatz: %.0f Zyklen/s\n", wall_s > 0 ? sim_stats.cycles / wall_s : 0.0);
+    printf("CPU-Auslastung: %.1f%% von %d virtuellen CPUs\n",
+           virtual_s > 0 ? utilization * 100.0 : 0.0, server_config.rt_cpus);
+    printf("Lateness: avg %.1f us, max %.1f us, Überläufe (Lateness > Periode): %lu\n",
+           sim_stats.cycles > 0 ? sim_stats.lateness_sum_ns / 1000.0 / sim_stats.cycles : 0.0,
+           sim_stats.lateness_max_ns / 1000.0, sim_stats.overruns);
+    printf("Prüfsumme: %016llx\n", (unsigned long long)sim_stats.digest);
+    return EXIT_SUCCESS;
+}
+
+// ========================================
+// KOMMANDOZEILE
+// ========================================
+void print_usage(const char* prog) {
+    printf("Usage: %s [-a acceptors] [-b backlog] [-c] [-r rate] [-B burst] [-u path] [-t] [-T] [-m sec] [-U users] [-k cpus]\n"
+           "       [-q handshakes] [-H ms] [-S ms] [-C cert] [-K key] [-n cycles]\n"
+           "       [-V sessions [-P ms] [-W us] [-J us]]\n", prog);
+    printf("  -a N   Anzahl SO_REUSEPORT-Acceptoren (1-%d, Default %d)\n", MAX_ACCEPTORS, DEFAULT_ACCEPTORS);
+    printf("  -b N   Listen-Backlog pro Acceptor (Default %d)\n", DEFAULT_LISTEN_BACKLOG);
+    printf("  -c     Verbindungen per BPF auf Acceptor der Empfangs-CPU lenken\n");
+    printf("  -r R   Verbindungen pro Sekunde und IP (0 = unbegrenzt, Default %d)\n", DEFAULT_RATE_LIMIT);
+    printf("  -B N   Burst-Größe des Rate-Limits (Default %d)\n", DEFAULT_RATE_BURST);
+    printf("  -u P   Unix-Socket für Handover (Default %s, \"\" = aus)\n", DEFAULT_HANDOVER_PATH);
+    printf("  -t     Listener und Sitzungen vom laufenden Server übernehmen (Neustart)\n");
+    printf("  -T     Kernel-TX-Zeitstempel (SO_TIMESTAMPING) pro Zyklus messen\n");
+    printf("  -m N   RT-Zustand aller Sitzungen alle N Sekunden ausgeben (0 = aus)\n");
+    printf("  -U P   Benutzerdatenbank mit RT-Quoten (Default %s)\n", DEFAULT_USER_DB);
+    printf("  -k N   CPUs für RT-Sitzungen, Kapazität N x %.0f%% (Default alle Online-CPUs)\n",
+           RT_UTILIZATION_LIMIT * 100.0);
+    printf("  -q N   Gleichzeitige Anmeldungen, älteste nicht angemeldete wird verdrängt (Default %d)\n", DEFAULT_MAX_HANDSHAKES);
+    printf("  -H MS  Frist Verbindung -> Benutzername (Default %d)\n", DEFAULT_USERNAME_TIMEOUT_MS);
+    printf("  -S MS  Frist Anmeldung -> RT-Start (Default %d)\n", DEFAULT_START_TIMEOUT_MS);
+    printf("  -C P   TLS 1.3 mit Zertifikat P, Records per kTLS im Kernel (Default aus)\n");
+    printf("  -K P   Privater Schlüssel zum Zertifikat (Default %s)\n", DEFAULT_TLS_KEY);
+    printf("  -n N   Zyklen pro Sitzung (Default %d)\n", MAX_CYCLES);
+    printf("  -V N   Simulation: N Sitzungen auf virtueller Uhr, ohne Netzwerk (1-%d)\n", MAX_SIM_SESSIONS);
+    printf("  -P MS  Periode der simulierten Sitzungen (Default %d)\n", TASK_PERIOD_SEC * 1000);
+    printf("  -W US  Simulierte Ausführungszeit pro Zyklus (Default %d)\n", DEFAULT_CYCLE_COST_US);
+    printf("  -J US  Maximaler Weck-Jitter der virtuellen Uhr (Default 0)\n");
+    printf("         Die virtuelle Uhr hat -k CPUs, Sitzungen konkurrieren nach Priorität\n");
+}
+
+int parse_arguments(int argc, char* argv[]) {
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "a:b:cr:B:u:tTm:U:k:q:H:S:C:K:n:V:P:W:J:h")) != -1) {
+        switch (opt) {
+        case 'a':
+            server_config.acceptor_count = atoi(optarg);
+            break;
+        case 'b':
+            server_config.listen_backlog = atoi(optarg);
+            break;
+        case 'c':
+            server_config.cpu_steering = 1;
+            break;
+        case 'r':
+            server_config.rate_limit = atof(optarg);
+            break;
+        case 'B':
+            server_config.rate_burst = atof(optarg);
+            break;
+        case 'u':
+            server_config.handover_path = optarg;
+            break;
+        case 't':
+            server_config.takeover = 1;
+            break;
+        case 'T':
+            server_config.tx_timestamps = 1;
+            break;
+        case 'm':
+            server_config.metrics_interval = atoi(optarg);
+            break;
+        case 'U':
+            server_config.user_db_path = optarg;
+            break;
+        case 'k':
+            server_config.rt_cpus = atoi(optarg);
+            break;
+        case 'q':
+            server_config.max_handshakes = atoi(optarg);
+            break;
+        case 'H':
+            server_config.username_timeout_ms = atoi(optarg);
+            break;
+        case 'S':
+            server_config.start_timeout_ms = atoi(optarg);
+            break;
+        case 'C':
+            server_config.tls_cert = optarg;
+            break;
+        case 'K':
+            server_config.tls_key = optarg;
+            break;
+        case 'n':
+            server_config.cycles = atoi(optarg);
+            break;
+        case 'V':
+            server_config.sim_sessions = atoi(optarg);
+            break;
+        case 'P':
+            server_config.sim_period_ms = atoi(optarg);
+            break;
+        case 'W':
+            server_config.sim_cost_us = atoll(optarg);
+            break;
+        case 'J':
+            server_config.sim_jitter_us = atoll(optarg);
+            break;
+        default:
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    
+    if (server_config.acceptor_count < 1 || server_config.acceptor_count > MAX_ACCEPTORS ||
+        server_config.listen_backlog < 1 || server_config.rate_limit < 0.0 ||
+        server_config.rate_burst < 1.0 || server_config.metrics_interval < 0 ||
+        server_config.rt_cpus < 0 ||
+        server_config.max_handshakes < 1 || server_config.max_handshakes > MAX_SESSIONS ||
+        server_config.username_timeout_ms < 1 || server_config.start_timeout_ms < 1 ||
+        server_config.cycles < 1 ||
+        server_config.sim_sessions < 0 || server_config.sim_sessions > MAX_SIM_SESSIONS ||
+        server_config.sim_period_ms < 1 || server_config.sim_cost_us < 0 || server_config.sim_jitter_us < 0 ||
+        (server_config.takeover && server_config.handover_path[0] == '\0')) {
+        printf("Ungültige Konfiguration\n");
+        print_usage(argv[0]);
+        return 0;
+    }
+    return 1;
+}
+
+// ========================================
+// MAIN SERVER FUNCTION
+// ========================================
+int main(int argc, char* argv[]) {
+    struct timespec now;
+    struct sigaction wakeup_action;
+    pthread_t handover_thread;
+    pthread_t metrics_thread;
+    pthread_t handshake_thread;
+    
+    if (!parse_arguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+    
+    // RT-Kapazität für die Admission Control (Simulation: virtuelle CPUs)
+    if (server_config.rt_cpus == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        server_config.rt_cpus = online > 0 ? (int)online : 1;
+    }
+    
+    // Simulation: gleicher RT-Pfad auf virtueller Uhr, ohne Listener und RT-Rechte
+    if (server_config.sim_sessions > 0) {
+        init_pi_mutex(&session_mutex);
+        return run_simulation();
+    }
+    
+    printf("=== SECURE REALTIME SERVER ===\n");
+    printf("Port: %d\n", SERVER_PORT);
+    printf("Autorisierte Client-IPs: %s, %s\n", AUTHORIZED_IP, ALTERNATIVE_IP);
+    printf("Acceptoren: %d, Backlog: %d, CPU-Steering: %s\n",
+           server_config.acceptor_count, server_config.listen_backlog,
+           server_config.cpu_steering ? "an" : "aus");
+    printf("Rate-Limit: %.1f Verbindungen/s pro IP (Burst %.0f)\n",
+           server_config.rate_limit, server_config.rate_burst);
+    
+    printf("RT-Kapazität: %d CPUs x %.0f%% = %.0f%% Auslastung\n",
+           server_config.rt_cpus, RT_UTILIZATION_LIMIT * 100.0,
+           server_config.rt_cpus * RT_UTILIZATION_LIMIT * 100.0);
+    if (!load_user_db(server_config.user_db_path)) {
+        return EXIT_FAILURE;
+    }
+    if (server_config.tls_cert != NULL) {
+        if (!init_tls(server_config.tls_cert, server_config.tls_key)) {
+            return EXIT_FAILURE;
+        }
+        printf("TLS 1.3: %s, kTLS-Offload angefordert\n", server_config.tls_cert);
+    }
+    printf("Für STRG+C zum Beenden\n\n");
+    
+    // Unvermeidbare Locks mit Priority Inheritance
+    init_pi_mutex(&session_mutex);
+    init_pi_mutex(&rate_limit_mutex);
+    
+    // Allowlist in Binärform umwandeln, Token-Buckets füllen
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for (int i = 0; i < ALLOWED_PEER_COUNT; i++) {
+        if (inet_pton(AF_INET, allowed_peers[i].ip, &allowed_peers[i].addr) != 1) {
+            printf("Ungültige autorisierte IP: %s\n", allowed_peers[i].ip);
+            return EXIT_FAILURE;
+        }
+        allowed_peers[i].tokens = server_config.rate_burst;
+        allowed_peers[i].last_refill = now;
+    }
+    
+    // Signal-Handler registrieren
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    
+    // SIGUSR1 ohne SA_RESTART: unterbricht clock_nanosleep() der RT-Threads beim Handover
+    memset(&wakeup_action, 0, sizeof(wakeup_action));
+    wakeup_action.sa_handler = handover_wakeup_handler;
+    sigemptyset(&wakeup_action.sa_mask);
+    sigaction(SIGUSR1, &wakeup_action, NULL);
+    
+    // Memory-Locking für RT-Performance
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        printf("Warnung: Memory-Locking fehlgeschlagen: %s\n", strerror(errno));
+    } else {
+        printf("Memory-Locking erfolgreich aktiviert\n");
+    }
+    
+    // Ein laufender Server ohne -t wäre ein Versehen: nicht beitreten
+    if (!server_config.takeover && server_config.handover_path[0] != '\0') {
+        int alive = handover_owner_alive(server_config.handover_path);
+        if (alive == 1) {
+            printf("✗ Auf %s antwortet bereits ein Server - Neustart mit -t, sonst anderen Pfad (-u)\n",
+                   server_config.handover_path);
+        }
+        if (alive != 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    
+    // 1. Listener der SO_REUSEPORT-Gruppe erstellen (einer pro Acceptor) oder
+    //    beim Neustart samt laufender Sitzungen vom Vorgänger übernehmen
+    if (server_config.takeover) {
+        if (!takeover_from_predecessor(server_config.handover_path)) {
+            return EXIT_FAILURE;
+        }
+    } else {
+        for (int i = 0; i < server_config.acceptor_count; i++) {
+            acceptors[i].index = i;
+            acceptors[i].listen_socket = create_listener();
+            acceptors[i].accepted = 0;
+            acceptors[i].rejected_ip = 0;
+            acceptors[i].rejected_rate = 0;
+            acceptors[i].rejected_queue = 0;
+            acceptors[i].idle = 0;
+            if (acceptors[i].listen_socket < 0) {
+                for (int j = 0; j < i; j++) {
+                    close(acceptors[j].listen_socket);
+                }
+                return EXIT_FAILURE;
+            }
+            acceptor_count = i + 1;
+        }
+    }
+    printf("Server lauscht auf Port %d (%d Listener)...\n", SERVER_PORT, acceptor_count);
+    
+    // Handover-Socket für den nächsten Neustart bereitstellen
+    if (server_config.handover_path[0] != '\0') {
+        handover_socket = create_handover_socket(server_config.handover_path);
+        if (handover_socket >= 0 &&
+            pthread_create(&handover_thread, NULL, handover_listener_loop, NULL) == 0) {
+            pthread_detach(handover_thread);
+            printf("Handover-Socket: %s (Neustart mit: %s -t)\n", server_config.handover_path, argv[0]);
+        } else {
+            printf("Warnung: Handover nicht verfügbar\n");
+        }
+    }
+    
+    // Handshake-Reaktor: alle Anmeldungen in einem Thread, nicht-blockierend
+    if (pipe(handshake_pipe) != 0 ||
+        fcntl(handshake_pipe[0], F_SETFL, O_NONBLOCK) != 0 ||
+        fcntl(handshake_pipe[1], F_SETFL, O_NONBLOCK) != 0 ||
+        pthread_create(&handshake_thread, NULL, handshake_loop, NULL) != 0) {
+        perror("handshake reactor");
+        return EXIT_FAILURE;
+    }
+    printf("Anmeldungen: max. %d gleichzeitig, Fristen %d ms (Benutzername) / %d ms (Start)\n",
+           server_config.max_handshakes, server_config.username_timeout_ms,
+           server_config.start_timeout_ms);
+    
+    // Optionale periodische Metriken (liest den RT-Zustand lockfrei per Seqlock)
+    if (server_config.metrics_interval > 0 &&
+        pthread_create(&metrics_thread, NULL, metrics_loop, NULL) == 0) {
+        pthread_detach(metrics_thread);
+    }
+    
+    // 2. Optional: BPF-Steering an die Gruppe hängen (gilt für alle Listener,
+    //    bei Übernahme bleibt das Programm des Vorgängers aktiv)
+    if (server_config.cpu_steering && acceptor_count > 1 && !server_config.takeover) {
+        if (attach_cpu_steering(acceptors[0].listen_socket, acceptor_count)) {
+            printf("CPU-Steering aktiv: Acceptor = CPU mod %d\n", acceptor_count);
+        } else {
+            printf("Warnung: CPU-Steering nicht verfügbar, Kernel verteilt per Hash\n");
+        }
+    }
+    
+    // 3. Acceptor-Threads starten
+    // Beim CPU-Steering wird Acceptor i auf alle CPUs c mit c % N == i gepinnt
+    // (genau die CPUs, die das BPF-Programm ihm zuteilt), damit accept() dort
+    // läuft, wo der Kernel die Verbindung empfangen hat
+    printf("Warte auf Client-Verbindungen...\n");
+    long cpu_ids = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpu_ids < 1 || cpu_ids > CPU_SETSIZE) {
+        cpu_ids = CPU_SETSIZE;
+    }
+    for (int i = 0; i < acceptor_count; i++) {
+        pthread_attr_t attr;
+        int ret;
+        
+        pthread_attr_init(&attr);
+        if (server_config.cpu_steering) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            for (long cpu = i; cpu < cpu_ids; cpu += acceptor_count) {
+                CPU_SET(cpu, &cpuset);
+            }
+            if (CPU_COUNT(&cpuset) > 0) {
+                pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+            }
+        }
+        
+        ret = pthread_create(&acceptors[i].thread_id, &attr, accept_loop, &acceptors[i]);
+        if (ret != 0 && server_config.cpu_steering) {
+            // Fallback ohne Pinning (z.B. mehr Acceptoren als CPUs)
+            ret = pthread_create(&acceptors[i].thread_id, NULL, accept_loop, &acceptors[i]);
+        }
+        pthread_attr_destroy(&attr);
+        
+        if (ret != 0) {
+            printf("Acceptor-Thread-Erstellung fehlgeschlagen: %s\n", strerror(ret));
+            server_running = 0;
+            for (int j = 0; j < acceptor_count; j++) {
+                shutdown(acceptors[j].listen_socket, SHUT_RDWR);
+            }
+            acceptor_count = i;
+            break;
+        }
+    }
+    
+    // 4. Auf Acceptoren warten (enden nach SIGINT/SIGTERM oder Handover)
+    for (int i = 0; i < acceptor_count; i++) {
+        pthread_join(acceptors[i].thread_id, NULL);
+    }
+    
+    pthread_join(handshake_thread, NULL);
+    
     // Cleanup
-    close(server_socket);
+    for (int i = 0; i < acceptor_count; i++) {
+        printf("Acceptor %d: %lu angenommen, %lu IP abgewiesen, %lu Rate-Limit, %lu Warteschlange voll\n",
+               i, acceptors[i].accepted, acceptors[i].rejected_ip, acceptors[i].rejected_rate,
+               acceptors[i].rejected_queue);
+    }
+    char handshake_line[BUFFER_SIZE];
+    format_handshake_stats(handshake_line, sizeof(handshake_line), 0);
+    printf("%s", handshake_line);
+    close(handshake_pipe[0]);
+    close(handshake_pipe[1]);
+    for (int i = 0; i < server_config.acceptor_count && i < MAX_ACCEPTORS; i++) {
+        if (acceptors[i].listen_socket >= 0) {
+            close(acceptors[i].listen_socket);   // Nach Handover nur die eigene Referenz
+        }
+    }
+    if (handover_socket >= 0) {
+        close(handover_socket);
+        if (!handover_done) {
+            unlink(server_config.handover_path);   // Sonst gehört der Pfad dem Nachfolger
+        }
+    }
+    if (tls_ctx != NULL) {
+        SSL_CTX_free(tls_ctx);   // Referenzgezählt, laufende Sitzungen behalten ihren Kontext
+    }
     munlockall(); // Speicher-Locking aufheben
     printf("Server beendet, alle Ressourcen freigegeben\n");
     
@@ -5,7 +5,11 @@ Projekt: Sicherheitsaspekte von Echtzeit-Embedded-Linux-Systemen
 Autor: Alexander Weber
 Datum: Juli 2025
 
-Dieses Programm erstellt einen einfachen Thread, der kontinuierlich eine Nachricht ausgibt.
+Dieses Programm erstellt einen Echtzeit-Thread, der eine statische Task-Tabelle als
+Rate-Monotonic Cyclic Executive (Haupt-/Nebenrahmen) abarbeitet.
+
+Mit -V läuft der Zeitplan auf einer virtuellen Uhr (rt_clock.h): Tasks werden
+durch ihre simulierte Ausführungszeit ersetzt, Millionen Rahmen in Sekunden.
 
 =====================================================================================================*/
 
@@ -19,17 +23,25 @@ Dieses Programm erstellt einen einfachen Thread, der kontinuierlich eine Nachric
 #include <time.h>         // Für präzise Zeitmessung (clock_nanosleep, etc.)
 #include <errno.h>        // Für Fehlerbehandlung
 #include <string.h>       // Für strerror()
+#include <math.h>         // Für pow() (Liu/Layland-Schranke)
 #include <sys/mman.h>     // Für Memory-Locking (mlockall)
 #include <sys/socket.h>   // Für Socket-Funktionen
 #include <netinet/in.h>   // Für IP-Adressen Strukturen
 #include <arpa/inet.h>    // Für inet_addr(), inet_ntoa()
 #include <ifaddrs.h>      // Für getifaddrs() - Interface-Adressen
+#include <getopt.h>       // Für Kommandozeilen-Optionen
+#include "rt_clock.h"     // Zeitquelle: echte oder virtuelle Uhr
 
 // Echtzeit-Konstanten
 #define RT_PRIORITY 50        // Echtzeit-Priorität (1-99 für SCHED_FIFO)
                               // 50 = Mittlerer Bereich, nicht zu aggressiv
-#define TASK_PERIOD_SEC 1     // Periode in Sekunden zwischen Task-Ausführungen
-#define MAX_CYCLES 10         // Maximale Anzahl Zyklen für Demo (begrenzt Laufzeit)
+#define MAX_CYCLES 20         // Anzahl Hauptrahmen für Demo (begrenzt Laufzeit)
+
+// Cyclic-Executive-Konstanten
+#define MAX_TASKS 16          // Maximale Größe der Task-Tabelle
+#define MAX_FRAMES 1000       // Maximale Nebenrahmen pro Hauptrahmen
+#define NSEC_PER_USEC 1000L
+#define NSEC_PER_SEC 1000000000L
 
 // Sicherheitskonstanten
 #define MAX_USERNAME_LENGTH 50
@@ -130,72 +142,442 @@ int check_network_security() {
     }
 }
 
-// Echtzeit-Thread-Funktion (ersetzt simple_task)
+// ========================================
+// TASK-FUNKTIONEN
+// ========================================
+// Simulierte periodische Funktionen einer Anwendung mit deterministischer
+// Arbeitslast (volatile verhindert Wegoptimieren der Schleifen)
+void sensor_sample(void)    { for (volatile int i = 0; i < 2000; i++); }
+void actuator_update(void)  { for (volatile int i = 0; i < 2000; i++); }
+void control_loop(void)     { for (volatile int i = 0; i < 10000; i++); }
+void state_estimator(void)  { for (volatile int i = 0; i < 8000; i++); }
+void supervision(void)      { for (volatile int i = 0; i < 20000; i++); }
+void diagnostics(void)      { for (volatile int i = 0; i < 20000; i++); }
+
+// ========================================
+// STATISCHE TASK-TABELLE
+// ========================================
+// Wird zur Build-Zeit festgelegt. Perioden müssen ganzzahlige Vielfache des
+// Nebenrahmens (ggT aller Perioden) sein, was per Konstruktion gilt.
+// priority bestimmt die Reihenfolge innerhalb eines Nebenrahmens (höher = früher);
+// Rate-Monotonic verlangt: kürzere Periode => höhere Priorität.
+// wcet_us ist das Zeitbudget, gegen das die Planbarkeit geprüft wird.
+typedef struct {
+    const char* name;
+    void (*function)(void);
+    long period_us;
+    long wcet_us;
+    int priority;
+} rt_task_t;
+
+static const rt_task_t task_table[] = {
+    { "sensor_sample",   sensor_sample,     1000,  50, 90 },   // 1 kHz
+    { "actuator_update", actuator_update,   1000,  50, 89 },   // 1 kHz
+    { "control_loop",    control_loop,     10000, 150, 80 },   // 100 Hz
+    { "state_estimator", state_estimator,  10000, 120, 79 },   // 100 Hz
+    { "supervision",     supervision,     100000, 300, 70 },   // 10 Hz
+    { "diagnostics",     diagnostics,     100000, 300, 69 },   // 10 Hz
+};
+#define TASK_COUNT ((int)(sizeof(task_table) / sizeof(task_table[0])))
+
+// ========================================
+// VORBERECHNETER ZEITPLAN
+// ========================================
+// Nebenrahmen (minor frame) = ggT aller Perioden, Hauptrahmen (major frame)
+// = kgV. frames[f] listet die im Nebenrahmen f freigegebenen Tasks in
+// Prioritätsreihenfolge; offset_frames verteilt langsame Tasks auf die
+// Nebenrahmen, damit nicht alle im Rahmen 0 landen.
+typedef struct {
+    int task_count;
+    int tasks[MAX_TASKS];
+    long load_us;                 // Summe der WCET-Budgets im Rahmen
+} frame_t;
+
+typedef struct {
+    long minor_us;
+    long major_us;
+    int frame_count;
+    int offset_frames[MAX_TASKS];
+    frame_t frames[MAX_FRAMES];
+} schedule_t;
+
+// Laufzeitstatistik pro Task (vom RT-Thread geschrieben, nach join ausgewertet)
+typedef struct {
+    unsigned long runs;
+    long long exec_max_ns;        // Reine Ausführungszeit
+    long long resp_min_ns;        // Antwortzeit = Ende - Freigabe (Rahmenbeginn)
+    long long resp_max_ns;
+    long long resp_sum_ns;
+    unsigned long deadline_misses;
+    unsigned long budget_overruns; // Ausführungszeit > wcet_us
+} task_stats_t;
+
+static schedule_t schedule;
+static task_stats_t task_stats[MAX_TASKS];
+static unsigned long frame_overruns = 0;
+
+// ========================================
+// ZEITQUELLE UND SIMULATION
+// ========================================
+// Alle Zeitabfragen der Zyklus-Logik laufen über rt_clock. Im Simulationsmodus
+// (-V) ersetzt rt_clock_consume() den Task-Aufruf: load_percent skaliert das
+// WCET-Budget (>100 provoziert Budget- und Rahmenüberläufe).
+static rt_clock_t* rt_clock = &rt_system_clock;
+static rt_clock_t virtual_clock;
+static int major_frames = MAX_CYCLES;
+static int load_percent = 100;
+static uint32_t jitter_seed = 1;
+static uint64_t response_digest = RT_CLOCK_DIGEST_INIT;   // Prüfsumme über alle Antwortzeiten
+
+long gcd_long(long a, long b) {
+    while (b != 0) {
+        long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+long long timespec_ns(const struct timespec* t) {
+    return (long long)t->tv_sec * NSEC_PER_SEC + t->tv_nsec;
+}
+
+void timespec_add_ns(struct timespec* t, long ns) {
+    t->tv_nsec += ns;
+    while (t->tv_nsec >= NSEC_PER_SEC) {
+        t->tv_nsec -= NSEC_PER_SEC;
+        t->tv_sec++;
+    }
+}
+
+// ========================================
+// ZEITPLAN ERSTELLEN
+// ========================================
+int build_schedule(void) {
+    int order[MAX_TASKS];
+    
+    if (TASK_COUNT < 1 || TASK_COUNT > MAX_TASKS) {
+        printf("✗ Task-Tabelle muss 1-%d Einträge haben\n", MAX_TASKS);
+        return 0;
+    }
+    
+    // Neben- und Hauptrahmen aus den Perioden ableiten
+    schedule.minor_us = task_table[0].period_us;
+    schedule.major_us = task_table[0].period_us;
+    for (int i = 1; i < TASK_COUNT; i++) {
+        schedule.minor_us = gcd_long(schedule.minor_us, task_table[i].period_us);
+        schedule.major_us = schedule.major_us / gcd_long(schedule.major_us, task_table[i].period_us)
+                            * task_table[i].period_us;
+    }
+    schedule.frame_count = schedule.major_us / schedule.minor_us;
+    if (schedule.frame_count > MAX_FRAMES) {
+        printf("✗ Hauptrahmen %ld us braucht %d Nebenrahmen (max. %d)\n",
+               schedule.major_us, schedule.frame_count, MAX_FRAMES);
+        return 0;
+    }
+    
+    // Tasks nach Priorität sortieren (Einfügesortierung, Tabelle ist klein)
+    for (int i = 0; i < TASK_COUNT; i++) {
+        int j = i;
+        while (j > 0 && task_table[order[j - 1]].priority < task_table[i].priority) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    
+    // In Prioritätsreihenfolge jedem Task den Versatz mit der geringsten
+    // maximalen Rahmenlast zuweisen und ihn in alle seine Rahmen eintragen
+    for (int k = 0; k < TASK_COUNT; k++) {
+        int t = order[k];
+        int stride = task_table[t].period_us / schedule.minor_us;
+        int best_offset = 0;
+        long best_load = -1;
+        
+        for (int offset = 0; offset < stride; offset++) {
+            long worst = 0;
+            for (int f = offset; f < schedule.frame_count; f += stride) {
+                if (schedule.frames[f].load_us > worst) worst = schedule.frames[f].load_us;
+            }
+            if (best_load < 0 || worst < best_load) {
+                best_load = worst;
+                best_offset = offset;
+            }
+        }
+        
+        schedule.offset_frames[t] = best_offset;
+        for (int f = best_offset; f < schedule.frame_count; f += stride) {
+            frame_t* frame = &schedule.frames[f];
+            frame->tasks[frame->task_count++] = t;
+            frame->load_us += task_table[t].wcet_us;
+        }
+    }
+    return 1;
+}
+
+// ========================================
+// PLANBARKEITSPRÜFUNG
+// ========================================
+// 1. Auslastung U = Σ wcet/period muss <= 1 sein (Liu/Layland-Schranke
+//    n(2^(1/n)-1) wird zur Information ausgegeben)
+// 2. Exakter Test für den Cyclic Executive: In jedem Nebenrahmen muss die
+//    Summe der WCET-Budgets in den Rahmen passen
+// 3. Rate-Monotonic-Prioritäten werden geprüft (Warnung bei Abweichung)
+int check_schedulability(void) {
+    double utilization = 0.0;
+    long worst_load = 0;
+    int worst_frame = 0;
+    int ok = 1;
+    
+    printf("=== CYCLIC EXECUTIVE: ZEITPLAN ===\n");
+    printf("Nebenrahmen: %ld us, Hauptrahmen: %ld us (%d Rahmen)\n",
+           schedule.minor_us, schedule.major_us, schedule.frame_count);
+    printf("  %-16s %8s %6s %5s %7s\n", "Task", "Periode", "WCET", "Prio", "Versatz");
+    
+    for (int i = 0; i < TASK_COUNT; i++) {
+        const rt_task_t* task = &task_table[i];
+        utilization += (double)task->wcet_us / task->period_us;
+        printf("  %-16s %6ldus %4ldus %5d %7d\n", task->name, task->period_us,
+               task->wcet_us, task->priority, schedule.offset_frames[i]);
+        
+        for (int j = 0; j < TASK_COUNT; j++) {
+            if (task_table[j].period_us < task->period_us && task_table[j].priority < task->priority) {
+                printf("⚠ %s hat kürzere Periode als %s, aber niedrigere Priorität (nicht Rate-Monotonic)\n",
+                       task_table[j].name, task->name);
+            }
+        }
+    }
+    
+    for (int f = 0; f < schedule.frame_count; f++) {
+        if (schedule.frames[f].load_us > worst_load) {
+            worst_load = schedule.frames[f].load_us;
+            worst_frame = f;
+        }
+    }
+    
+    double bound = TASK_COUNT * (pow(2.0, 1.0 / TASK_COUNT) - 1.0);
+    printf("Auslastung: %.1f%% (Liu/Layland-Schranke für %d Tasks: %.1f%%)\n",
+           utilization * 100.0, TASK_COUNT, bound * 100.0);
+    printf("Maximale Rahmenlast: %ld us von %ld us (Rahmen %d)\n",
+           worst_load, schedule.minor_us, worst_frame);
+    
+    if (utilization > 1.0) {
+        printf("✗ Nicht planbar: Auslastung über 100%%\n");
+        ok = 0;
+    }
+    if (worst_load > schedule.minor_us) {
+        printf("✗ Nicht planbar: Rahmen %d überschreitet den Nebenrahmen\n", worst_frame);
+        ok = 0;
+    }
+    if (ok) {
+        printf("✓ Zeitplan ist planbar\n\n");
+    }
+    return ok;
+}
+
+// ========================================
+// ANTWORTZEIT-BERICHT
+// ========================================
+void print_task_report(void) {
+    printf("\n=== ANTWORTZEITEN PRO TASK ===\n");
+    printf("  %-16s %6s %9s %9s %9s %9s %6s %6s\n",
+           "Task", "Läufe", "Exec max", "Resp min", "Resp avg", "Resp max", "Miss", "Budget");
+    for (int i = 0; i < TASK_COUNT; i++) {
+        task_stats_t* st = &task_stats[i];
+        if (st->runs == 0) {
+            printf("  %-16s %6d\n", task_table[i].name, 0);
+            continue;
+        }
+        printf("  %-16s %6lu %7.1fus %7.1fus %7.1fus %7.1fus %6lu %6lu\n",
+               task_table[i].name, st->runs,
+               st->exec_max_ns / 1000.0,
+               st->resp_min_ns / 1000.0,
+               st->resp_sum_ns / 1000.0 / st->runs,
+               st->resp_max_ns / 1000.0,
+               st->deadline_misses, st->budget_overruns);
+    }
+    printf("Rahmenüberläufe: %lu\n", frame_overruns);
+}
+
+// Echtzeit-Thread-Funktion: Cyclic Executive
+// Arbeitet den vorberechneten Zeitplan Nebenrahmen für Nebenrahmen ab.
+// Alle Tasks laufen in diesem einen SCHED_FIFO-Thread - keine Kontextwechsel
+// zwischen Tasks, die Reihenfolge im Rahmen ergibt sich aus der Priorität.
 void *realtime_task(void *arg) {
     (void)arg; // Parameter nicht verwendet, Compiler-Warning vermeiden
-    struct timespec next_period, current_time;
+    struct timespec next_frame, release, task_start, task_end, current_time;
     int cycle_count = 0;
+    int frame = 0;
+    uint32_t jitter_state = jitter_seed;
     
-    printf("Echtzeit-Thread gestartet mit Priorität %d\n", RT_PRIORITY);
+    printf("Echtzeit-Thread gestartet mit Priorität %d (Uhr: %s)\n", RT_PRIORITY, rt_clock->name);
     
     // === TIMING-INITIALISIERUNG ===
     // Aktuelle Zeit als Startpunkt setzen - CLOCK_MONOTONIC ist wichtig:
     // - Wird nicht von Systemzeit-Änderungen beeinflusst
     // - Perfekt für Echtzeit-Anwendungen mit relativen Zeitintervallen
-    if (clock_gettime(CLOCK_MONOTONIC, &next_period) != 0) {
+    if (rt_clock_now(rt_clock, &next_frame) != 0) {
         perror("clock_gettime");
         return NULL;
     }
     
     // === HAUPTSCHLEIFE ===
-    // Führt MAX_CYCLES Zyklen aus, jeder genau TASK_PERIOD_SEC Sekunden nach dem vorherigen
-    while (cycle_count < MAX_CYCLES) {
-        // === PERIODE BERECHNEN ===
-        // Nächste Periode berechnen (1 Sekunde später)
+    // Führt major_frames Hauptrahmen aus, jeder aus schedule.frame_count Nebenrahmen
+    while (cycle_count < major_frames) {
+        // === NÄCHSTEN NEBENRAHMEN BERECHNEN ===
         // Wichtig: Wir addieren zur ABSOLUTEN Zeit, nicht zur aktuellen Zeit
         // Dies verhindert "Timing-Drift" - Akkumulation kleiner Verzögerungen
-        next_period.tv_sec += TASK_PERIOD_SEC;
+        timespec_add_ns(&next_frame, schedule.minor_us * NSEC_PER_USEC);
         
         // === PRÄZISE WARTEZEIT ===
         // clock_nanosleep() mit TIMER_ABSTIME wartet bis zu einem absoluten Zeitpunkt
-        // Vorteile gegenüber sleep(1):
-        // - Nanosekunden-Genauigkeit statt Sekunden
-        // - Absoluter Zeitpunkt verhindert Drift
-        // - Unterbrechungen durch Signale können behandelt werden
-        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_period, NULL) != 0) {
-            if (errno != EINTR) {  // EINTR = Unterbrochen durch Signal (OK)
-                perror("clock_nanosleep");
-                break;
-            }
+        int ret;
+        do {
+            ret = rt_clock_sleep_until(rt_clock, &next_frame, &jitter_state, RT_PRIORITY, 0);
+        } while (ret == EINTR);   // EINTR = Unterbrochen durch Signal (OK)
+        if (ret != 0) {
+            printf("clock_nanosleep: %s\n", strerror(ret));
+            break;
         }
+        release = next_frame;   // Freigabezeitpunkt aller Tasks dieses Rahmens
         
-        // === ZEITMESSUNG FÜR ANALYSE ===
-        // Aktuelle Zeit messen um die tatsächliche Ausführungszeit zu dokumentieren
-        clock_gettime(CLOCK_MONOTONIC, &current_time);
+        // === TASKS DES NEBENRAHMENS AUSFÜHREN ===
+        const frame_t* current = &schedule.frames[frame];
+        for (int k = 0; k < current->task_count; k++) {
+            int t = current->tasks[k];
+            task_stats_t* st = &task_stats[t];
+            
+            rt_clock_now(rt_clock, &task_start);
+            if (rt_clock->simulated) {
+                rt_clock_consume(rt_clock, task_table[t].wcet_us * NSEC_PER_USEC * load_percent / 100,
+                                 RT_PRIORITY, 0);
+            } else {
+                task_table[t].function();
+            }
+            rt_clock_now(rt_clock, &task_end);
+            
+            long long exec_ns = timespec_ns(&task_end) - timespec_ns(&task_start);
+            long long resp_ns = timespec_ns(&task_end) - timespec_ns(&release);
+            
+            st->runs++;
+            st->resp_sum_ns += resp_ns;
+            if (exec_ns > st->exec_max_ns) st->exec_max_ns = exec_ns;
+            if (st->runs == 1 || resp_ns < st->resp_min_ns) st->resp_min_ns = resp_ns;
+            if (resp_ns > st->resp_max_ns) st->resp_max_ns = resp_ns;
+            if (resp_ns > task_table[t].period_us * NSEC_PER_USEC) st->deadline_misses++;
+            if (exec_ns > task_table[t].wcet_us * NSEC_PER_USEC) st->budget_overruns++;
+            response_digest = rt_clock_digest(response_digest, resp_ns);
+        }
         
-        // === ECHTZEIT-TASK AUSFÜHREN ===
-        // In einer echten Anwendung würde hier die kritische Echtzeit-Arbeit stattfinden
-        // z.B.: Sensordaten lesen, Aktoren steuern, Kommunikation, etc.
-        printf("[Zyklus %02d] Echtzeit-Task ausgeführt um %ld.%03ld\n", 
-               ++cycle_count, 
-               current_time.tv_sec, 
-               current_time.tv_nsec / 1000000);  // Nanosekunden zu Millisekunden
+        // === RAHMENÜBERLAUF ERKENNEN ===
+        // Arbeit des Rahmens reicht in den nächsten hinein: Der Plan läuft auf dem
+        // absoluten Raster weiter, der nächste Rahmen startet entsprechend verspätet
+        rt_clock_now(rt_clock, &current_time);
+        if (timespec_ns(&current_time) - timespec_ns(&release) > schedule.minor_us * NSEC_PER_USEC) {
+            frame_overruns++;
+        }
         
-        // === DETERMINISTISCHE ARBEITSLAST SIMULIEREN ===
-        // volatile verhindert Compiler-Optimierung (Loop würde sonst wegoptimiert)
-        // In Echtzeit-Systemen ist wichtig, dass Arbeitslasten vorhersagbare Dauer haben
-        for (volatile int i = 0; i < 100000; i++);
+        // === HAUPTRAHMEN ABGESCHLOSSEN ===
+        if (++frame == schedule.frame_count) {
+            frame = 0;
+            if (rt_clock->simulated) {
+                cycle_count++;   // Keine Ausgabe pro Zyklus: würde die Simulation dominieren
+                continue;
+            }
+            printf("[Zyklus %02d] Hauptrahmen ausgeführt um %ld.%03ld\n", 
+                   ++cycle_count, 
+                   current_time.tv_sec, 
+                   current_time.tv_nsec / 1000000);  // Nanosekunden zu Millisekunden
+        }
     }
     
-    printf("Echtzeit-Thread beendet nach %d Zyklen\n", cycle_count);
+    printf("Echtzeit-Thread beendet nach %d Hauptrahmen\n", cycle_count);
     return NULL;
 }
 
-int main() {
+// ========================================
+// SIMULATIONSLAUF (VIRTUELLE UHR)
+// ========================================
+// Gleicher Zeitplan, gleiche Zyklus-Logik - nur die Zeitquelle ist virtuell.
+// Keine Authentifizierung, kein mlockall/SCHED_FIFO: Es wird nichts in
+// Echtzeit ausgeführt. Gleiche Parameter ergeben die gleiche Prüfsumme.
+int run_simulation(long long max_jitter_ns) {
+    pthread_t thread;
+    struct timespec wall_start, wall_end, virtual_end;
+    
+    // Zyklischer Executive: alle Tasks laufen nacheinander im RT-Thread auf einer CPU
+    rt_virtual_clock_init(&virtual_clock, 0, max_jitter_ns, 1);
+    rt_clock = &virtual_clock;
+    rt_clock_attach(rt_clock);   // Einziger Teilnehmer: der RT-Thread
+    
+    printf("=== SIMULATION: %d Hauptrahmen, Last %d%%, Jitter %lld us, Seed %u ===\n",
+           major_frames, load_percent, max_jitter_ns / NSEC_PER_USEC, jitter_seed);
+    
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    if (pthread_create(&thread, NULL, realtime_task, NULL) != 0) {
+        perror("pthread_create");
+        return EXIT_FAILURE;
+    }
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    rt_clock_now(rt_clock, &virtual_end);
+    
+    print_task_report();
+    
+    double wall_s = (timespec_ns(&wall_end) - timespec_ns(&wall_start)) / 1e9;
+    double virtual_s = timespec_ns(&virtual_end) / 1e9;
+    long long minor_frames = (long long)major_frames * schedule.frame_count;
+    printf("Virtuelle Dauer: %.3f s, Echtzeit: %.3f s (Faktor %.0f)\n",
+           virtual_s, wall_s, wall_s > 0 ? virtual_s / wall_s : 0.0);
+    printf("Durchsatz: %.0f Nebenrahmen/s\n", wall_s > 0 ? minor_frames / wall_s : 0.0);
+    printf("Prüfsumme: %016llx\n", (unsigned long long)response_digest);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
     pthread_t thread;
     pthread_attr_t attr;
     struct sched_param param;
     int ret;
+    int simulate = 0;
+    long long max_jitter_us = 0;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "Vn:j:L:s:h")) != -1) {
+        switch (opt) {
+        case 'V':
+            simulate = 1;
+            break;
+        case 'n':
+            major_frames = atoi(optarg);
+            break;
+        case 'j':
+            max_jitter_us = atoll(optarg);
+            break;
+        case 'L':
+            load_percent = atoi(optarg);
+            break;
+        case 's':
+            jitter_seed = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        default:
+            printf("Usage: %s [-V] [-n major_frames] [-j jitter_us] [-L load_percent] [-s seed]\n", argv[0]);
+            printf("  -V  Virtuelle Uhr (Simulation, keine Echtzeit)\n");
+            printf("  -j, -L, -s wirken nur mit -V\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (major_frames < 1 || load_percent < 0 || max_jitter_us < 0) {
+        printf("Ungültige Parameter\n");
+        return EXIT_FAILURE;
+    }
+    
+    if (simulate) {
+        if (!build_schedule() || !check_schedulability()) {
+            return EXIT_FAILURE;
+        }
+        return run_simulation(max_jitter_us * NSEC_PER_USEC);
+    }
     
     printf("=== Echtzeit-Thread Demo ===\n");
     printf("PREEMPT-RT Kernel empfohlen für beste Performance\n\n");
@@ -225,6 +607,16 @@ int main() {
         return EXIT_FAILURE;
     }
     
+    // ========================================
+    // ZEITPLAN UND PLANBARKEIT
+    // ========================================
+    // Vor jeder RT-Initialisierung: Ein nicht planbarer Task-Satz wird gar
+    // nicht erst gestartet
+    if (!build_schedule() || !check_schedulability()) {
+        printf("Task-Tabelle anpassen (Perioden, WCET-Budgets) und neu kompilieren.\n");
+        return EXIT_FAILURE;
+    }
+    
     printf("=== ECHTZEIT-INITIALISIERUNG ===\n");
     
     // ========================================
@@ -324,6 +716,7 @@ int main() {
     // pthread_join() wartet bis Thread beendet ist
     // Wichtig für saubere Programmbeendigung
     pthread_join(thread, NULL);
+    print_task_report();
     
     // ========================================
     // SCHRITT 6: RESSOURCEN FREIGEBEN
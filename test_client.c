@@ -4,18 +4,213 @@ Autor: Alexander Weber
 Datum: Juli 2025
 
 Einfacher Test-Client zum Testen der Server-Funktionalität
+Misst zusätzlich die Einweg-Latenz jedes Zyklus (Server-Sendezeitpunkt tx_ns -> Empfang)
+Mit -t verbindet der Client per TLS 1.3 (Server mit -C gestartet)
 =====================================================================================================*/
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <getopt.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
 
 #define SERVER_PORT 8080
 #define BUFFER_SIZE 256
+#define DEFAULT_SYNC_SAMPLES 8    // SYNC-Pings für den Uhrenabgleich bei entferntem Server
+
+// ========================================
+// VERBINDUNG (KLARTEXT ODER TLS)
+// ========================================
+// Der Client hat genau eine Verbindung; tls ist nach dem TLS-Handshake gesetzt.
+// Mit kTLS-RX entschlüsselt der Kernel, SSL_read() liest dann direkt vom Socket.
+SSL* tls = NULL;
+
+ssize_t conn_send(int sock, const void* data, size_t len) {
+    if (tls != NULL) {
+        int n = SSL_write(tls, data, (int)len);
+        return n > 0 ? n : -1;
+    }
+    return send(sock, data, len, 0);
+}
+
+ssize_t conn_recv(int sock, void* data, size_t len) {
+    if (tls != NULL) {
+        int n = SSL_read(tls, data, (int)len);
+        return n > 0 ? n : (SSL_get_error(tls, n) == SSL_ERROR_ZERO_RETURN ? 0 : -1);
+    }
+    return recv(sock, data, len, 0);
+}
+
+// TLS-1.3-Handshake; mit ca_file wird das Server-Zertifikat geprüft
+// (selbstsigniertes Testzertifikat = eigene CA), sonst nur angezeigt
+int start_tls(int sock, const char* ca_file) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    if (ctx == NULL || !SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION)) {
+        ERR_print_errors_fp(stdout);
+        return 0;
+    }
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+    if (ca_file != NULL) {
+        if (SSL_CTX_load_verify_locations(ctx, ca_file, NULL) != 1) {
+            printf("CA-Datei %s nicht lesbar\n", ca_file);
+            SSL_CTX_free(ctx);
+            return 0;
+        }
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, NULL);
+    }
+    
+    tls = SSL_new(ctx);
+    SSL_CTX_free(ctx);   // SSL hält eine eigene Referenz
+    if (tls == NULL || SSL_set_fd(tls, sock) != 1 || SSL_connect(tls) != 1) {
+        printf("✗ TLS-Handshake fehlgeschlagen\n");
+        ERR_print_errors_fp(stdout);
+        return 0;
+    }
+    
+    X509* cert = SSL_get1_peer_certificate(tls);
+    char subject[BUFFER_SIZE] = "?";
+    if (cert != NULL) {
+        X509_NAME_oneline(X509_get_subject_name(cert), subject, sizeof(subject));
+        X509_free(cert);
+    }
+    printf("✓ %s, %s, Server %s (%s), kTLS RX %s\n",
+           SSL_get_version(tls), SSL_get_cipher_name(tls), subject,
+           ca_file != NULL ? "geprüft" : "ungeprüft",
+           BIO_get_ktls_recv(SSL_get_rbio(tls)) ? "aktiv" : "aus");
+    return 1;
+}
+
+// ========================================
+// ZEILENWEISES LESEN
+// ========================================
+// TCP liefert einen Bytestrom: Eine Zyklus-Meldung kann auf mehrere recv()
+// verteilt sein oder mehrere Meldungen in einem recv() ankommen. rx_ns ist
+// der Empfangszeitpunkt (CLOCK_MONOTONIC) des recv(), das die Zeile abschloss.
+typedef struct {
+    char buffer[BUFFER_SIZE * 4];
+    size_t used;
+    long long rx_ns;
+} line_reader_t;
+
+long long monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Liefert die Länge der nächsten Zeile (inkl. '\n') oder -1 bei Verbindungsende
+int read_line(int sock, line_reader_t* reader, char* line, size_t line_size) {
+    for (;;) {
+        char* newline = memchr(reader->buffer, '\n', reader->used);
+        if (newline != NULL || reader->used == sizeof(reader->buffer)) {
+            size_t len = newline ? (size_t)(newline + 1 - reader->buffer) : reader->used;
+            size_t copy = len < line_size - 1 ? len : line_size - 1;
+            memcpy(line, reader->buffer, copy);
+            line[copy] = '\0';
+            memmove(reader->buffer, reader->buffer + len, reader->used - len);
+            reader->used -= len;
+            return (int)copy;
+        }
+        
+        ssize_t n = conn_recv(sock, reader->buffer + reader->used, sizeof(reader->buffer) - reader->used);
+        reader->rx_ns = monotonic_ns();
+        if (n <= 0) {
+            if (reader->used > 0) {   // Unvollständige letzte Zeile ausgeben
+                size_t copy = reader->used < line_size - 1 ? reader->used : line_size - 1;
+                memcpy(line, reader->buffer, copy);
+                line[copy] = '\0';
+                reader->used = 0;
+                return (int)copy;
+            }
+            return -1;
+        }
+        reader->used += n;
+    }
+}
+
+// ========================================
+// UHRENABGLEICH
+// ========================================
+// NTP-Verfahren über dieselbe Verbindung: t1 (Client sendet), t2 (Server-Uhr),
+// t4 (Client empfängt). offset = t2 - (t1 + t4) / 2 ist die Abweichung der
+// Server-Uhr; verwendet wird die Probe mit der kleinsten Round-Trip-Zeit.
+int estimate_clock_offset(int sock, line_reader_t* reader, int samples,
+                          long long* offset_ns, long long* rtt_ns) {
+    char line[BUFFER_SIZE];
+    char request[64];
+    int valid = 0;
+    
+    for (int i = 0; i < samples; i++) {
+        long long t1 = monotonic_ns();
+        long long echoed, t2;
+        
+        snprintf(request, sizeof(request), "SYNC %lld\n", t1);
+        if (conn_send(sock, request, strlen(request)) < 0) {
+            break;
+        }
+        if (read_line(sock, reader, line, sizeof(line)) < 0) {
+            break;
+        }
+        long long t4 = reader->rx_ns;
+        
+        // Server ohne Uhrenabgleich: Zeile ist bereits RT-Ausgabe
+        if (sscanf(line, "SYNC %lld %lld", &echoed, &t2) != 2 || echoed != t1) {
+            printf("%s", line);
+            break;
+        }
+        
+        long long rtt = t4 - t1;
+        if (valid == 0 || rtt < *rtt_ns) {
+            *rtt_ns = rtt;
+            *offset_ns = t2 - (t1 + t4) / 2;
+        }
+        valid++;
+    }
+    
+    conn_send(sock, "SYNC DONE\n", 10);
+    return valid;
+}
+
+// ========================================
+// LATENZ-STATISTIK
+// ========================================
+int compare_ll(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+void print_latency_report(long long* latencies, int count, long long offset_ns, int synced) {
+    long long sum = 0;
+    
+    printf("\n=== EINWEG-LATENZ (Sitzung) ===\n");
+    if (count == 0) {
+        printf("Keine Zyklen mit Server-Zeitstempel empfangen\n");
+        return;
+    }
+    
+    qsort(latencies, count, sizeof(long long), compare_ll);
+    for (int i = 0; i < count; i++) {
+        sum += latencies[i];
+    }
+    
+    printf("Uhr: %s, Offset %.3f us\n",
+           synced ? "per SYNC abgeglichen" : "gleiche Uhr (Loopback)", offset_ns / 1000.0);
+    printf("Samples: %d\n", count);
+    printf("min %.1f us | avg %.1f us | p50 %.1f us | p90 %.1f us | p99 %.1f us | max %.1f us\n",
+           latencies[0] / 1000.0,
+           sum / 1000.0 / count,
+           latencies[count / 2] / 1000.0,
+           latencies[(count * 90) / 100] / 1000.0,
+           latencies[(count * 99) / 100] / 1000.0,
+           latencies[count - 1] / 1000.0);
+}
 
 int main(int argc, char *argv[]) {
     int client_socket;
@@ -24,9 +219,30 @@ int main(int argc, char *argv[]) {
     char username[50];
     ssize_t bytes_received;
     const char* server_ip = "127.0.0.1";  // Standardmäßig localhost
+    int sync_samples = -1;                // -1 = automatisch (Loopback: gleiche Uhr)
+    int use_tls = 0;
+    const char* ca_file = NULL;
+    int opt;
     
-    if (argc > 1) {
-        server_ip = argv[1];
+    while ((opt = getopt(argc, argv, "s:tC:h")) != -1) {
+        switch (opt) {
+        case 's':
+            sync_samples = atoi(optarg);
+            break;
+        case 't':
+            use_tls = 1;
+            break;
+        case 'C':
+            use_tls = 1;
+            ca_file = optarg;
+            break;
+        default:
+            printf("Usage: %s [-s sync_samples] [-t] [-C ca.pem] [server_ip]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind < argc) {
+        server_ip = argv[optind];
     }
     
     printf("=== SECURE RT CLIENT ===\n");
@@ -59,9 +275,14 @@ int main(int argc, char *argv[]) {
     
     printf("✓ Verbindung zum Server hergestellt\n");
     
+    if (use_tls && !start_tls(client_socket, ca_file)) {
+        close(client_socket);
+        return EXIT_FAILURE;
+    }
+    
     // 4. Authentifizierungsaufforderung empfangen
     memset(buffer, 0, sizeof(buffer));
-    bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+    bytes_received = conn_recv(client_socket, buffer, sizeof(buffer) - 1);
     if (bytes_received > 0) {
         buffer[bytes_received] = '\0';
         printf("%s", buffer);  // Auth-Prompt ausgeben
@@ -69,12 +290,12 @@ int main(int argc, char *argv[]) {
     
     // 5. Benutzername eingeben und senden
     if (fgets(username, sizeof(username), stdin) != NULL) {
-        send(client_socket, username, strlen(username), 0);
+        conn_send(client_socket, username, strlen(username));
     }
     
     // 6. Authentifizierungsantwort empfangen
     memset(buffer, 0, sizeof(buffer));
-    bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+    bytes_received = conn_recv(client_socket, buffer, sizeof(buffer) - 1);
     if (bytes_received > 0) {
         buffer[bytes_received] = '\0';
         printf("%s", buffer);
@@ -86,28 +307,77 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    // 7. Uhrenabgleich: Auf Loopback laufen Client und Server auf derselben
+    //    CLOCK_MONOTONIC, sonst Offset per SYNC-Pings schätzen (-s erzwingt Pings)
+    line_reader_t reader = { .used = 0, .rx_ns = 0 };
+    long long offset_ns = 0;
+    long long rtt_ns = 0;
+    int synced = 0;
+    
+    if (sync_samples < 0) {
+        sync_samples = (ntohl(server_addr.sin_addr.s_addr) >> 24) == 127 ? 0 : DEFAULT_SYNC_SAMPLES;
+    }
+    if (sync_samples == 0) {
+        conn_send(client_socket, "SYNC DONE\n", 10);
+    } else {
+        synced = estimate_clock_offset(client_socket, &reader, sync_samples, &offset_ns, &rtt_ns);
+        if (synced) {
+            printf("Uhrenabgleich: %d Proben, Offset %.3f us, min. RTT %.3f us\n",
+                   synced, offset_ns / 1000.0, rtt_ns / 1000.0);
+        } else {
+            printf("Warnung: Kein Uhrenabgleich möglich, Latenzen ohne Offset-Korrektur\n");
+        }
+    }
+    
     printf("\n=== ECHTZEIT-DATEN EMPFANGEN ===\n");
     
-    // 7. RT-Thread-Daten kontinuierlich empfangen
+    // 8. RT-Thread-Daten kontinuierlich empfangen und Latenz je Zyklus erfassen
+    long long* latencies = NULL;
+    int latency_count = 0;
+    int latency_capacity = 0;
+    
     while (1) {
-        memset(buffer, 0, sizeof(buffer));
-        bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-        
-        if (bytes_received <= 0) {
+        if (read_line(client_socket, &reader, buffer, sizeof(buffer)) < 0) {
             printf("Verbindung zum Server beendet\n");
             break;
         }
         
-        buffer[bytes_received] = '\0';
         printf("%s", buffer);
         
+        // Server-Sendezeitpunkt auswerten: Latenz = Empfang - (Senden + Offset)
+        char* tx = strstr(buffer, "tx_ns=");
+        long long tx_ns;
+        if (tx != NULL && sscanf(tx, "tx_ns=%lld", &tx_ns) == 1) {
+            if (latency_count == latency_capacity) {
+                int new_capacity = latency_capacity ? latency_capacity * 2 : 64;
+                long long* grown = realloc(latencies, new_capacity * sizeof(long long));
+                if (grown != NULL) {
+                    latencies = grown;
+                    latency_capacity = new_capacity;
+                }
+            }
+            if (latency_count < latency_capacity) {
+                latencies[latency_count++] = reader.rx_ns - (tx_ns - offset_ns);
+            }
+        }
+        
         // Wenn "COMPLETED" empfangen, ist RT-Thread beendet
         if (strstr(buffer, "COMPLETED") != NULL) {
+            // Abschlusszeile ("Executed N cycles") gehört noch zur Meldung
+            if (read_line(client_socket, &reader, buffer, sizeof(buffer)) > 0) {
+                printf("%s", buffer);
+            }
             printf("Echtzeit-Thread abgeschlossen\n");
             break;
         }
     }
     
+    print_latency_report(latencies, latency_count, offset_ns, synced);
+    free(latencies);
+    
+    if (tls != NULL) {
+        SSL_free(tls);
+    }
     close(client_socket);
     printf("Client beendet\n");
     return EXIT_SUCCESS;
@@ -0,0 +1,288 @@
+/* TLS-Benchmark für Secure Realtime Server
+=====================================================================================================
+Autor: Alexander Weber
+Datum: Juli 2025
+
+Vergleicht den Sendepfad des Servers auf Loopback in drei Varianten:
+  plain  - send() im Klartext (bisheriger Server)
+  tls    - SSL_write(), Verschlüsselung im Nutzerraum (OpenSSL)
+  ktls   - send() nach TLS-Handshake, Verschlüsselung im Kernel (TLS_TX)
+Gemessen werden Durchsatz und CPU-Zeit des Sende-Threads - das ist die Zeit,
+die im Server der RT-Thread pro Zyklus für send() aufwendet.
+=====================================================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#define DEFAULT_TOTAL_MB 64
+#define DEFAULT_CERT "server.crt"
+#define DEFAULT_KEY "server.key"
+#define RECV_BUFFER_SIZE 65536
+#define MAX_MESSAGE_SIZE 16384        // Maximale TLS-Record-Nutzlast
+
+typedef enum {
+    MODE_PLAIN,
+    MODE_TLS,
+    MODE_KTLS
+} bench_mode_t;
+
+static const char* mode_names[] = { "plain", "tls", "ktls" };
+
+// ========================================
+// EMPFÄNGER-THREAD
+// ========================================
+// Entspricht dem Client: verbindet, macht bei TLS den Handshake (SSL_read,
+// ggf. mit kTLS RX) und verwirft alle Daten bis total_bytes empfangen sind.
+typedef struct {
+    int socket;
+    bench_mode_t mode;
+    long long total_bytes;
+    int ok;
+} receiver_t;
+
+long long thread_cpu_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+long long monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void* receiver_loop(void* arg) {
+    receiver_t* receiver = (receiver_t*)arg;
+    char* buffer = malloc(RECV_BUFFER_SIZE);
+    SSL_CTX* ctx = NULL;
+    SSL* ssl = NULL;
+    long long received = 0;
+    
+    if (buffer == NULL) {
+        return NULL;
+    }
+    
+    if (receiver->mode != MODE_PLAIN) {
+        ctx = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_min_proto_version(ctx, TLS1_3_VERSION);
+        SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+        ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, receiver->socket);
+        if (SSL_connect(ssl) != 1) {
+            ERR_print_errors_fp(stdout);
+            goto done;
+        }
+    }
+    
+    while (received < receiver->total_bytes) {
+        int n = ssl != NULL ? SSL_read(ssl, buffer, RECV_BUFFER_SIZE)
+                            : (int)recv(receiver->socket, buffer, RECV_BUFFER_SIZE, 0);
+        if (n <= 0) {
+            break;
+        }
+        received += n;
+    }
+    receiver->ok = received == receiver->total_bytes;
+
+done:
+    SSL_free(ssl);
+    SSL_CTX_free(ctx);
+    free(buffer);
+    return NULL;
+}
+
+// ========================================
+// LOOPBACK-VERBINDUNG
+// ========================================
+int connect_loopback(int* sender, int* receiver) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listener, 1) < 0 || getsockname(listener, (struct sockaddr*)&addr, &len) < 0) {
+        perror("listener");
+        return 0;
+    }
+    
+    *receiver = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(*receiver, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        close(listener);
+        return 0;
+    }
+    *sender = accept(listener, NULL, NULL);
+    close(listener);
+    return *sender >= 0;
+}
+
+// ========================================
+// EIN BENCHMARK-LAUF
+// ========================================
+// Sender = Server-Seite (SSL_accept), wie im RT-Server. Gibt 0 zurück, wenn
+// die Variante nicht verfügbar ist (z.B. kein kTLS im Kernel).
+int run_bench(SSL_CTX* server_ctx, bench_mode_t mode, size_t message_size, long long total_bytes) {
+    int sender_socket, receiver_socket;
+    receiver_t receiver;
+    pthread_t receiver_thread;
+    SSL* ssl = NULL;
+    char* message = malloc(message_size);
+    long long sent = 0;
+    int available = 1;
+    
+    if (message == NULL || !connect_loopback(&sender_socket, &receiver_socket)) {
+        free(message);
+        return 0;
+    }
+    memset(message, 'x', message_size);
+    
+    receiver.socket = receiver_socket;
+    receiver.mode = mode;
+    receiver.total_bytes = total_bytes;
+    receiver.ok = 0;
+    pthread_create(&receiver_thread, NULL, receiver_loop, &receiver);
+    
+    if (mode != MODE_PLAIN) {
+        SSL_CTX_clear_options(server_ctx, SSL_OP_ENABLE_KTLS);
+        if (mode == MODE_KTLS) {
+            SSL_CTX_set_options(server_ctx, SSL_OP_ENABLE_KTLS);
+        }
+        ssl = SSL_new(server_ctx);
+        SSL_set_fd(ssl, sender_socket);
+        if (SSL_accept(ssl) != 1) {
+            ERR_print_errors_fp(stdout);
+            available = 0;
+        } else if (mode == MODE_KTLS && !BIO_get_ktls_send(SSL_get_wbio(ssl))) {
+            printf("%-6s %7zu  nicht verfügbar (Kernel ohne TLS-ULP oder Cipher nicht offloadbar)\n",
+                   mode_names[mode], message_size);
+            available = 0;
+        }
+    }
+    
+    if (available) {
+        long long start_ns = monotonic_ns();
+        long long start_cpu = thread_cpu_ns();
+        
+        while (sent < total_bytes) {
+            size_t chunk = total_bytes - sent < (long long)message_size ? (size_t)(total_bytes - sent) : message_size;
+            ssize_t n;
+            
+            // plain und ktls: identischer Aufruf, der Kernel verschlüsselt bei ktls
+            if (mode == MODE_TLS) {
+                n = SSL_write(ssl, message, (int)chunk);
+            } else {
+                n = send(sender_socket, message, chunk, MSG_NOSIGNAL);
+            }
+            if (n <= 0) {
+                printf("%s: Senden fehlgeschlagen\n", mode_names[mode]);
+                break;
+            }
+            sent += n;
+        }
+        
+        long long cpu_ns = thread_cpu_ns() - start_cpu;
+        long long messages = (total_bytes + message_size - 1) / message_size;
+        
+        // Abbruch: Der Empfänger wartet sonst ewig auf die fehlenden Bytes
+        if (sent < total_bytes) {
+            shutdown(sender_socket, SHUT_RDWR);
+        }
+        
+        // Erst Empfang abwarten, damit die Zeit den gesamten Transfer abdeckt
+        pthread_join(receiver_thread, NULL);
+        long long wall_ns = monotonic_ns() - start_ns;
+        
+        printf("%-6s %7zu  %10.1f MB/s  %8.3f us/send  %8.1f ms CPU (Sender)%s\n",
+               mode_names[mode], message_size,
+               total_bytes / 1e6 / (wall_ns / 1e9),
+               cpu_ns / 1000.0 / messages,
+               cpu_ns / 1e6,
+               receiver.ok ? "" : "  [unvollständig]");
+    } else {
+        shutdown(sender_socket, SHUT_RDWR);
+        pthread_join(receiver_thread, NULL);
+    }
+    
+    SSL_free(ssl);
+    close(sender_socket);
+    close(receiver_socket);
+    free(message);
+    return available;
+}
+
+int main(int argc, char* argv[]) {
+    const char* cert = DEFAULT_CERT;
+    const char* key = DEFAULT_KEY;
+    long long total_mb = DEFAULT_TOTAL_MB;
+    size_t sizes[] = { 64, 1024, 16384 };   // Zyklus-Zeile bis voller TLS-Record
+    int size_count = sizeof(sizes) / sizeof(sizes[0]);
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "s:n:C:K:h")) != -1) {
+        switch (opt) {
+        case 's':
+            sizes[0] = (size_t)atol(optarg);
+            size_count = 1;
+            break;
+        case 'n':
+            total_mb = atoll(optarg);
+            break;
+        case 'C':
+            cert = optarg;
+            break;
+        case 'K':
+            key = optarg;
+            break;
+        default:
+            printf("Usage: %s [-s message_size] [-n total_mb] [-C cert] [-K key]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (total_mb < 1 || sizes[0] < 1 || sizes[0] > MAX_MESSAGE_SIZE) {
+        printf("Ungültige Parameter (Nachricht 1-%d Bytes, mindestens 1 MB)\n", MAX_MESSAGE_SIZE);
+        return EXIT_FAILURE;
+    }
+    
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Gleiche TLS-Konfiguration wie der Server (init_tls in secure_rt_server.c)
+    SSL_CTX* server_ctx = SSL_CTX_new(TLS_server_method());
+    if (server_ctx == NULL ||
+        !SSL_CTX_set_min_proto_version(server_ctx, TLS1_3_VERSION) ||
+        SSL_CTX_use_certificate_chain_file(server_ctx, cert) != 1 ||
+        SSL_CTX_use_PrivateKey_file(server_ctx, key, SSL_FILETYPE_PEM) != 1) {
+        printf("✗ Zertifikat/Schlüssel nicht ladbar (%s, %s) - erst \"make certs\"\n", cert, key);
+        ERR_print_errors_fp(stdout);
+        return EXIT_FAILURE;
+    }
+    SSL_CTX_set_ciphersuites(server_ctx, "TLS_AES_128_GCM_SHA256");
+    SSL_CTX_set_num_tickets(server_ctx, 0);
+    
+    printf("=== TLS-BENCHMARK (Loopback, %lld MB pro Lauf, TLS_AES_128_GCM_SHA256) ===\n", total_mb);
+    printf("%-6s %7s  %15s  %15s  %s\n", "Modus", "Bytes", "Durchsatz", "CPU/Aufruf", "CPU gesamt");
+    
+    for (int i = 0; i < size_count; i++) {
+        for (int mode = MODE_PLAIN; mode <= MODE_KTLS; mode++) {
+            run_bench(server_ctx, (bench_mode_t)mode, sizes[i], total_mb * 1000000LL);
+        }
+    }
+    
+    SSL_CTX_free(server_ctx);
+    return EXIT_SUCCESS;
+}